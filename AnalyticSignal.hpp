@@ -0,0 +1,89 @@
+#ifndef ASU_ANALYTICSIGNAL
+#define ASU_ANALYTICSIGNAL
+// Need sci-libs/fftw
+
+#include<vector>
+#include<cmath>
+
+extern "C"{
+#include<fftw3.h>
+}
+
+#include<FFTWPlanCache.hpp>
+
+/**************************************************************
+ * This C++ template calculate the analytic signal x+iy of the
+ * input trace x, where y is the Hilbert transform of x (x phase
+ * shifted by -90 deg., same as ShiftPhase(x,-90)).
+ *
+ * One fft and one ifft (cached plans, see FFTWPlanCache.hpp); the
+ * spectrum is rotated by multiplying -i. The envelope and the
+ * instantaneous phase are calculated from x and y in the same pass.
+ *
+ * input(s):
+ * const vector<T> &x               ----  Input signal.
+ * const bool      &ReturnEnvelope  ----  (Optional, default is true) calculate the envelope.
+ * const bool      &ReturnPhase     ----  (Optional, default is false) calculate the instantaneous phase.
+ *
+ * return(s):
+ * AnalyticSignalResults ans  ----  {Hilbert,Envelope,Phase}
+ *                                  Hilbert : y.
+ *                                  Envelope: sqrt(x^2+y^2) (empty if not requested).
+ *                                  Phase   : atan2(y,x), in rad. (empty if not requested).
+ *
+ * Shule Yu
+ * Oct 17 2026
+ *
+ * Dependence: fftw-3.
+ *
+ * Key words : analytic signal, hilbert, envelope, instantaneous phase.
+**************************************************************/
+
+struct AnalyticSignalResults{
+    std::vector<double> Hilbert,Envelope,Phase;
+};
+
+template<typename T>
+AnalyticSignalResults AnalyticSignal(const std::vector<T> &x, const bool &ReturnEnvelope=true, const bool &ReturnPhase=false){
+
+    AnalyticSignalResults ans;
+    if (x.empty()) return ans;
+
+    int n=x.size(),N=n+(n%2),K=N/2+1;
+
+    double *In=FFTWPlanCache::Real(N);
+    fftw_complex *Out=FFTWPlanCache::Complex(K);
+
+    // Pad the signal with one zero if the length of original signal is odd.
+    for (int i=0;i<n;++i) In[i]=x[i];
+    if (n%2==1) In[N-1]=0;
+
+    fftw_execute_dft_r2c(FFTWPlanCache::R2C(N),In,Out);
+
+    // Multiply by -i (DC and Nyquist become zero).
+    for (int i=0;i<K;++i) {
+        double re=Out[i][0];
+        Out[i][0]=Out[i][1];
+        Out[i][1]=-re;
+    }
+    Out[0][0]=Out[0][1]=Out[K-1][0]=Out[K-1][1]=0;
+
+    fftw_execute_dft_c2r(FFTWPlanCache::C2R(N),Out,In);
+
+    ans.Hilbert.resize(n);
+    for (int i=0;i<n;++i) ans.Hilbert[i]=In[i]/n;
+
+    if (ReturnEnvelope) {
+        ans.Envelope.resize(n);
+        for (int i=0;i<n;++i) ans.Envelope[i]=sqrt(ans.Hilbert[i]*ans.Hilbert[i]+1.0*x[i]*x[i]);
+    }
+
+    if (ReturnPhase) {
+        ans.Phase.resize(n);
+        for (int i=0;i<n;++i) ans.Phase[i]=atan2(ans.Hilbert[i],1.0*x[i]);
+    }
+
+    return ans;
+}
+
+#endif
@@ -1,19 +1,20 @@
 #ifndef ASU_BUTTERWORTH
 #define ASU_BUTTERWORTH
-// Need SAC
 
 #include<iostream>
 #include<vector>
+#include<array>
+#include<algorithm>
 
-extern "C"{
-#include<sac.h>
-#include<sacio.h>
-}
+#include<ButterworthSOS.hpp>
 
 /*****************************************************
  * This C++ template apply butterworth filter on data.
- * The filter is provided by SAC library.
- * This is only a wrapper.
+ *
+ * The filter is the same as SAC's xapiir (BU), designed once per
+ * (f1,f2,order,delta) as second-order sections (see ButterworthSOS.hpp)
+ * and applied in double precision. It doesn't need the SAC library and
+ * is thread-safe.
  *
  * input(s):
  * vector<T>   &p        ----  A signal array (2D).
@@ -22,6 +23,7 @@ extern "C"{
  * const double &f2      ----  Filter right corner.
  * const int    &order   ----  (optional, default=2) Number of poles.
  * const int    &passes  ----  (optional, default=2) Number of passes (forward->backward->forward ...)
+ *                             2 is zero-phase.
  *
  * return(s):
  * vector<T> &p (in-place)
@@ -35,9 +37,49 @@ extern "C"{
  * Shule Yu
  * Dec 25 2017
  *
- * Key words: sac, filter, butterworth.
+ * Key words: filter, butterworth.
 *****************************************************/
 
+namespace ButterworthHidden {
+
+    // Run the cascade over x[0..n-1] once, forward or backward, from rest.
+    inline void Pass(double *x, const int &n, const std::vector<std::array<double,5>> &sos, const bool &Forward){
+
+        int M=sos.size();
+        std::vector<std::array<double,4>> z(M,{{0,0,0,0}});   // {x[-1],x[-2],y[-1],y[-2]} of each section.
+
+        for (int Cnt=0;Cnt<n;++Cnt) {
+            double &v=x[Forward?Cnt:n-1-Cnt];
+            double in=v;
+            for (int i=0;i<M;++i) {
+                const auto &s=sos[i];
+                auto &w=z[i];
+                double out=s[0]*in+s[1]*w[0]+s[2]*w[1]-s[4]*w[3]-s[3]*w[2];   // y[-1] last: shorter dependency chain.
+                w[1]=w[0];w[0]=in;
+                w[3]=w[2];w[2]=out;
+                in=out;
+            }
+            v=in;
+        }
+    }
+
+    inline void Filter(double *x, const int &n, const std::vector<std::array<double,5>> &sos, const int &passes){
+        for (int i=0;i<passes;++i) Pass(x,n,sos,i%2==0);
+    }
+
+    inline void Filter(std::vector<double> &p, const std::vector<std::array<double,5>> &sos, const int &passes){
+        Filter(p.data(),p.size(),sos,passes);
+    }
+
+    template<typename T>
+    void Filter(std::vector<T> &p, const std::vector<std::array<double,5>> &sos, const int &passes){
+        static thread_local std::vector<double> x;
+        x.assign(p.begin(),p.end());
+        Filter(x.data(),x.size(),sos,passes);
+        std::copy(x.begin(),x.end(),p.begin());
+    }
+}
+
 template<typename T>
 void Butterworth(std::vector<T> &p, const double &delta, const double &f1, const double &f2,
                  const int &order=2, const int passes=2){
@@ -52,31 +94,14 @@ void Butterworth(std::vector<T> &p, const double &delta, const double &f1, const
         return;
     }
 
-    if (f1<=0 && f2>=nf) return;
-
-    int N=p.size();
-
-    // Call SAC function.
-    float *rawdata= new float [N];
-
-    // In sac.h, we have:
-    char *BU = (char *)"BU";
-    char *BP = (char *)"BP";
-    char *HP = (char *)"HP";
-    char *LP = (char *)"LP";
-
-    for (int Cnt=0;Cnt<N;++Cnt) rawdata[Cnt]=p[Cnt];
-
-    if (f1<=0)
-        xapiir(rawdata,N,BU,0.0,0.0,order,LP,0.0,f2,delta,passes);
-    else if (f2>=nf)
-        xapiir(rawdata,N,BU,0.0,0.0,order,HP,f1,0.0,delta,passes);
-    else
-        xapiir(rawdata,N,BU,0.0,0.0,order,BP,f1,f2,delta,passes);
+    if (order<1) {
+        std::cerr <<  "Error in " << __func__ << ": filter order is wrong ..." << std::endl;
+        return;
+    }
 
-    for (int Cnt=0;Cnt<N;++Cnt) p[Cnt]=rawdata[Cnt];
+    if (f1<=0 && f2>=nf) return;
 
-    delete [] rawdata;
+    ButterworthHidden::Filter(p,ButterworthSOS(delta,f1,f2,order),passes);
 
     return ;
 }
@@ -0,0 +1,164 @@
+#ifndef ASU_BUTTERWORTHBATCH
+#define ASU_BUTTERWORTHBATCH
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<algorithm>
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include<immintrin.h>
+#endif
+
+#include<Butterworth.hpp>
+#include<ButterworthSOS.hpp>
+
+/*****************************************************************
+ * This C++ template apply the same butterworth filter on many signals.
+ *
+ * The recursion of an IIR filter can't be vectorized along time, but it
+ * can across signals: signals of the same length are interleaved, 8
+ * (AVX-512) or 4 (AVX, or plain C++) at a time, and the second-order
+ * sections run on all of them together, one signal per SIMD lane. The
+ * result for each signal is the same as Butterworth(*p[i],...), up to
+ * round-off.
+ *
+ * Signals of different lengths can be mixed; only signals of the same
+ * length are grouped. Enable the SIMD instructions at compile time (e.g.
+ * -march=native).
+ *
+ * input(s):
+ * const vector<vector<T>*> &p  ----  Pointers to the signal arrays.
+ * const double &delta          ----  Data sampling (in sec.), same for all signals.
+ * const double &f1             ----  Filter left corner.
+ * const double &f2             ----  Filter right corner.
+ * const int    &order          ----  (optional, default=2) Number of poles.
+ * const int    &passes         ----  (optional, default=2) Number of passes (forward->backward->forward ...)
+ *
+ * return(s):
+ * *p[i] (in-place)
+ *
+ * Note: same corner frequency rules as Butterworth.hpp.
+ *
+ * Shule Yu
+ * Oct 17 2026
+ *
+ * Key words: filter, butterworth, batch, simd.
+*****************************************************************/
+
+namespace ButterworthBatchHidden {
+
+#if defined(__AVX512F__)
+    const int Lanes=8;
+    typedef __m512d Vec;
+    inline Vec Load(const double *p){return _mm512_loadu_pd(p);}
+    inline void Store(double *p, const Vec &a){_mm512_storeu_pd(p,a);}
+    inline Vec Broadcast(const double &a){return _mm512_set1_pd(a);}
+    inline Vec Add(const Vec &a, const Vec &b){return _mm512_add_pd(a,b);}
+    inline Vec Sub(const Vec &a, const Vec &b){return _mm512_sub_pd(a,b);}
+    inline Vec Mul(const Vec &a, const Vec &b){return _mm512_mul_pd(a,b);}
+#elif defined(__AVX__)
+    const int Lanes=4;
+    typedef __m256d Vec;
+    inline Vec Load(const double *p){return _mm256_loadu_pd(p);}
+    inline void Store(double *p, const Vec &a){_mm256_storeu_pd(p,a);}
+    inline Vec Broadcast(const double &a){return _mm256_set1_pd(a);}
+    inline Vec Add(const Vec &a, const Vec &b){return _mm256_add_pd(a,b);}
+    inline Vec Sub(const Vec &a, const Vec &b){return _mm256_sub_pd(a,b);}
+    inline Vec Mul(const Vec &a, const Vec &b){return _mm256_mul_pd(a,b);}
+#elif defined(__SSE2__)
+    const int Lanes=2;
+    typedef __m128d Vec;
+    inline Vec Load(const double *p){return _mm_loadu_pd(p);}
+    inline void Store(double *p, const Vec &a){_mm_storeu_pd(p,a);}
+    inline Vec Broadcast(const double &a){return _mm_set1_pd(a);}
+    inline Vec Add(const Vec &a, const Vec &b){return _mm_add_pd(a,b);}
+    inline Vec Sub(const Vec &a, const Vec &b){return _mm_sub_pd(a,b);}
+    inline Vec Mul(const Vec &a, const Vec &b){return _mm_mul_pd(a,b);}
+#else
+    // four independent recursions still overlap in the pipeline.
+    const int Lanes=4;
+    struct Vec {double v[4];};
+    inline Vec Load(const double *p){return {{p[0],p[1],p[2],p[3]}};}
+    inline void Store(double *p, const Vec &a){std::copy(a.v,a.v+4,p);}
+    inline Vec Broadcast(const double &a){return {{a,a,a,a}};}
+    inline Vec Add(const Vec &a, const Vec &b){return {{a.v[0]+b.v[0],a.v[1]+b.v[1],a.v[2]+b.v[2],a.v[3]+b.v[3]}};}
+    inline Vec Sub(const Vec &a, const Vec &b){return {{a.v[0]-b.v[0],a.v[1]-b.v[1],a.v[2]-b.v[2],a.v[3]-b.v[3]}};}
+    inline Vec Mul(const Vec &a, const Vec &b){return {{a.v[0]*b.v[0],a.v[1]*b.v[1],a.v[2]*b.v[2],a.v[3]*b.v[3]}};}
+#endif
+
+    // One pass over interleaved samples (x[t*Lanes+lane]), section by
+    // section, from rest. Same operation order as ButterworthHidden::Pass.
+    inline void Pass(double *x, const int &n, const std::vector<std::array<double,5>> &sos, const bool &Forward){
+        for (const auto &s: sos) {
+            Vec b0=Broadcast(s[0]),b1=Broadcast(s[1]),b2=Broadcast(s[2]),a1=Broadcast(s[3]),a2=Broadcast(s[4]);
+            Vec x1=Broadcast(0),x2=x1,y1=x1,y2=x1;
+            for (int Cnt=0;Cnt<n;++Cnt) {
+                double *v=x+(Forward?Cnt:n-1-Cnt)*Lanes;
+                Vec in=Load(v);
+                Vec out=Sub(Sub(Add(Add(Mul(b0,in),Mul(b1,x1)),Mul(b2,x2)),Mul(a2,y2)),Mul(a1,y1));
+                x2=x1;x1=in;
+                y2=y1;y1=out;
+                Store(v,out);
+            }
+        }
+    }
+
+    // Filter up to Lanes signals of length n together.
+    template<typename T>
+    void Filter(const std::vector<std::vector<T>*> &p, const std::size_t &n, const std::vector<std::array<double,5>> &sos, const int &passes){
+        static thread_local std::vector<double> x;
+        x.assign(n*Lanes,0);
+        std::size_t m=p.size();
+        std::vector<T *> q(m);
+        for (std::size_t l=0;l<m;++l) q[l]=p[l]->data();
+
+        for (std::size_t i=0;i<n;++i)
+            for (std::size_t l=0;l<m;++l) x[i*Lanes+l]=q[l][i];
+        for (int i=0;i<passes;++i) Pass(x.data(),n,sos,i%2==0);
+        for (std::size_t i=0;i<n;++i)
+            for (std::size_t l=0;l<m;++l) q[l][i]=x[i*Lanes+l];
+    }
+}
+
+template<typename T>
+void ButterworthBatch(const std::vector<std::vector<T>*> &p, const double &delta, const double &f1, const double &f2,
+                      const int &order=2, const int passes=2){
+
+    // check corner frequencies.
+    double nf=1.0/2/delta;
+    if (f1>=f2 || f1>=nf || f2<=0) {
+        std::cerr <<  "Error in " << __func__ << ": corner frequency range is wrong ..." << std::endl;
+        return;
+    }
+
+    if (order<1) {
+        std::cerr <<  "Error in " << __func__ << ": filter order is wrong ..." << std::endl;
+        return;
+    }
+
+    if (f1<=0 && f2>=nf) return;
+
+    const auto &sos=ButterworthSOS(delta,f1,f2,order);
+
+    // group signals by length.
+    std::vector<std::vector<T>*> q;
+    for (const auto &item: p)
+        if (item!=nullptr && !item->empty()) q.push_back(item);
+    std::stable_sort(q.begin(),q.end(),[](const std::vector<T> *a, const std::vector<T> *b){
+        return a->size()<b->size();
+    });
+
+    std::size_t i=0;
+    while (i<q.size()) {
+        std::size_t j=i+1,n=q[i]->size();
+        while (j<q.size() && j-i<(std::size_t)ButterworthBatchHidden::Lanes && q[j]->size()==n) ++j;
+        if (j-i==1) ButterworthHidden::Filter(*q[i],sos,passes);
+        else ButterworthBatchHidden::Filter(std::vector<std::vector<T>*>(q.begin()+i,q.begin()+j),n,sos,passes);
+        i=j;
+    }
+
+    return ;
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef ASU_BUTTERWORTHSOS
+#define ASU_BUTTERWORTHSOS
+
+#include<map>
+#include<array>
+#include<tuple>
+#include<cmath>
+#include<mutex>
+#include<vector>
+#include<complex>
+
+/***********************************************************************
+ * This C++ function returns a digital butterworth filter as a cascade of
+ * second-order sections (the same design as SAC's xapiir: analog
+ * butterworth prototype, transformed to low/high/band pass at pre-warped
+ * corners, then bilinear transform).
+ *
+ * Each section is {b0,b1,b2,a1,a2}:
+ *
+ *              b0 + b1 z^-1 + b2 z^-2
+ *     H(z) = --------------------------
+ *               1 + a1 z^-1 + a2 z^-2
+ *
+ * First order sections (odd order) have b2=a2=0.
+ *
+ * Designs are cached by (f1,f2,order,delta) for the whole program: the
+ * first call designs the filter, later calls (from any thread) return the
+ * same sections.
+ *
+ * input(s):
+ * const double &delta  ----  Data sampling (in sec.)
+ * const double &f1     ----  Filter left corner.
+ * const double &f2     ----  Filter right corner.
+ * const int    &order  ----  Number of poles.
+ *
+ * return(s):
+ * const vector<array<double,5>> &ans  ----  Second-order sections.
+ *
+ * Note:
+ *       if f1<=0, design a low pass filter of corner f2.
+ *       if f2>=1.0/delta/2, design a high pass filter of corner f1.
+ *       Otherwise design a band pass filter (with 2*order poles).
+ *       Corner frequencies are not checked here, see Butterworth.hpp.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: filter, butterworth, second-order sections, bilinear.
+***********************************************************************/
+
+namespace ButterworthSOSHidden {
+
+    typedef std::array<double,5> Section;
+
+    // Analog section (coefficients in ascending powers of s) to digital, by
+    // s=(1-z^-1)/(1+z^-1). The corners are pre-warped for this mapping.
+    inline Section Bilinear(const std::array<double,3> &n, const std::array<double,3> &d){
+        if (d[2]==0) {
+            double s=d[0]+d[1];
+            return {{(n[0]+n[1])/s,(n[0]-n[1])/s,0,(d[0]-d[1])/s,0}};
+        }
+        double s=d[0]+d[1]+d[2];
+        return {{(n[0]+n[1]+n[2])/s,2*(n[0]-n[2])/s,(n[0]-n[1]+n[2])/s,2*(d[0]-d[2])/s,(d[0]-d[1]+d[2])/s}};
+    }
+
+    inline std::vector<Section> Design(const double &delta, const double &f1, const double &f2, const int &order){
+
+        double wl=std::tan(M_PI*f1*delta),wh=std::tan(M_PI*f2*delta);
+        int Type=(f1<=0?0:(f2>=0.5/delta?1:2));   // 0: low pass, 1: high pass, 2: band pass.
+        double a=wl*wh,b=wh-wl;
+
+        std::vector<Section> ans;
+
+        // Real pole at -1 (odd order).
+        if (order%2==1) {
+            if (Type==0) ans.push_back(Bilinear({{1,0,0}},{{1,1/wh,0}}));
+            else if (Type==1) ans.push_back(Bilinear({{0,1,0}},{{wl,1,0}}));
+            else ans.push_back(Bilinear({{0,b,0}},{{a,b,1}}));
+        }
+
+        // Complex pole pairs on the left half of the unit circle.
+        for (int k=1;k<=order/2;++k) {
+            std::complex<double> p=std::polar(1.0,M_PI*(0.5+(2.0*k-1)/(2*order)));
+            if (Type==0) ans.push_back(Bilinear({{1,0,0}},{{1,-2*p.real()/wh,1/wh/wh}}));
+            else if (Type==1) ans.push_back(Bilinear({{0,0,1}},{{wl*wl,-2*p.real()*wl,1}}));
+            else {
+                // each low pass pole maps to two band pass poles.
+                std::complex<double> q=std::sqrt(b*b*p*p-4*a);
+                for (const auto &r: {0.5*(b*p+q),0.5*(b*p-q)})
+                    ans.push_back(Bilinear({{0,b,0}},{{std::norm(r),-2*r.real(),1}}));
+            }
+        }
+
+        return ans;
+    }
+}
+
+inline const std::vector<std::array<double,5>> &ButterworthSOS(const double &delta, const double &f1, const double &f2, const int &order){
+
+    typedef std::tuple<double,double,int,double> Key;
+    Key key(f1,f2,order,delta);
+
+    // per-thread copy of the lookup table (designs are never destroyed).
+    static thread_local std::map<Key,const std::vector<std::array<double,5>> *> local;
+    auto it=local.find(key);
+    if (it!=local.end()) return *(it->second);
+
+    static std::map<Key,std::vector<std::array<double,5>>> designs;
+    static std::mutex m;
+    std::lock_guard<std::mutex> lock(m);
+    auto it2=designs.find(key);
+    if (it2==designs.end())
+        it2=designs.emplace(key,ButterworthSOSHidden::Design(delta,f1,f2,order)).first;
+    local[key]=&(it2->second);
+    return it2->second;
+}
+
+#endif
@@ -1,8 +1,18 @@
 #ifndef ASU_CONVOLVE
 #define ASU_CONVOLVE
+// Need sci-libs/fftw
 
 #include<iostream>
 #include<vector>
+#include<cmath>
+#include<algorithm>
+
+extern "C"{
+#include<fftw3.h>
+}
+
+#include<FFTWPlanCache.hpp>
+#include<NextFFTSize.hpp>
 
 /***********************************************************
  * This C++ template returns convolution result of two input
@@ -24,6 +34,11 @@
  *                              true,  the convlove result will be divided by the
  *                                     summation of y over the overlapping points.
  *
+ * Short inputs are convolved directly (O(m*n)). When both x and y are
+ * long, FFT overlap-add is used instead (the longer one is cut into
+ * blocks, each block is convolved with the shorter one through FFT). The
+ * result is the same up to round-off.
+ *
  * return(s):
  * vector<double> ans  ----  Convolve result.
  *
@@ -31,9 +46,60 @@
  * Shule Yu
  * Dec 29 2017
  *
- * Key words: convolution.
+ * Dependence: fftw-3.
+ *
+ * Key words: convolution, fft, overlap-add.
 ***********************************************************/
 
+namespace ConvolveHidden {
+
+    // FFT length for overlap-add of a length n kernel (n<=m): several
+    // kernel lengths per block, one block if the whole result fits.
+    inline int BlockFFTSize(const int &m, const int &n){
+        return NextFFTSize(std::min(m+n-1,std::max(8*n,1024)));
+    }
+
+    // rough costs in multiply-adds: the direct sum, against the block
+    // transforms plus the plan set-up.
+    inline bool UseFFT(const int &m, const int &n){
+        int a=std::max(m,n),b=std::min(m,n),L=BlockFFTSize(a,b);
+        double Blocks=std::ceil(1.0*a/(L-b+1));
+        return 1.0*a*b>2*(2*Blocks+1)*L*std::log2(L)+1e5;
+    }
+
+    // Full convolution of x and y (n<=m) by overlap-add.
+    inline std::vector<double> OverlapAdd(const std::vector<double> &x, const std::vector<double> &y){
+        int m=x.size(),n=y.size(),L=BlockFFTSize(m,n),B=L-n+1,K=L/2+1;
+        std::vector<double> ans(m+n-1,0);
+
+        double *In=FFTWPlanCache::Real(L);
+        fftw_complex *X=FFTWPlanCache::Complex(K);
+        fftw_complex *Y=FFTWPlanCache::Complex(K,1);
+        fftw_plan p1=FFTWPlanCache::R2C(L),p2=FFTWPlanCache::C2R(L);
+
+        std::copy(y.begin(),y.end(),In);
+        std::fill(In+n,In+L,0.0);
+        fftw_execute_dft_r2c(p1,In,Y);
+
+        for (int b=0;b<m;b+=B){
+            int len=std::min(B,m-b);
+            std::copy(x.begin()+b,x.begin()+b+len,In);
+            std::fill(In+len,In+L,0.0);
+            fftw_execute_dft_r2c(p1,In,X);
+            for (int k=0;k<K;++k){
+                double re=X[k][0]*Y[k][0]-X[k][1]*Y[k][1];
+                double im=X[k][0]*Y[k][1]+X[k][1]*Y[k][0];
+                X[k][0]=re/L;
+                X[k][1]=im/L;
+            }
+            fftw_execute_dft_c2r(p2,X,In);
+            int End=std::min(len+n-1,m+n-1-b);
+            for (int i=0;i<End;++i) ans[b+i]+=In[i];
+        }
+        return ans;
+    }
+}
+
 template<typename T1, typename T2>
 std::vector<double> Convolve(const std::vector<T1> &x, const std::vector<T2> &y,
                              const bool &Cut=false, const bool &Normalize=false){
@@ -50,17 +116,36 @@ std::vector<double> Convolve(const std::vector<T1> &x, const std::vector<T2> &y,
         Size=Front+m;
     }
 
-    std::vector<double> ans;
+    if (ConvolveHidden::UseFFT(m,n)) {
+
+        std::vector<double> X(x.begin(),x.end()),Y(y.begin(),y.end());
+        auto full=(m>=n?ConvolveHidden::OverlapAdd(X,Y):ConvolveHidden::OverlapAdd(Y,X));
+        std::vector<double> ans(full.begin()+Front,full.begin()+Size);
+
+        // W: sum of y over the overlapping points, from prefix sums of y.
+        if (Normalize) {
+            std::vector<double> P(n+1,0);
+            for (int k=0;k<n;++k) P[k+1]=P[k]+y[k];
+            for (int i=Front;i<Size;++i){
+                int Begin=std::max(i-n+1,0);
+                int End=std::min(i+1,m);
+                double W=P[i-Begin+1]-P[i-End+1];
+                if (W!=0) ans[i-Front]/=W;
+            }
+        }
+        return ans;
+    }
+
+    std::vector<double> ans(Size-Front,0);
     for (int i=Front;i<Size;++i){
-        ans.push_back(0);
         int Begin=std::max(i-n+1,0);
         int End=std::min(i+1,m);
         double W=0;
         for (int j=Begin;j<End;++j) {
-            ans.back()+=x[j]*y[i-j];
+            ans[i-Front]+=x[j]*y[i-j];
             W+=y[i-j];
         }
-        if (Normalize && W!=0) ans.back()/=W;
+        if (Normalize && W!=0) ans[i-Front]/=W;
     }
 
     return ans;
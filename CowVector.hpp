@@ -0,0 +1,72 @@
+#ifndef ASU_COWVECTOR
+#define ASU_COWVECTOR
+
+#include<vector>
+#include<memory>
+#include<atomic>
+
+/*************************************************************
+ * This C++ template class is a copy-on-write std::vector.
+ *
+ * Copies share one buffer, so copying is O(1). Reading goes through the
+ * const interface (or Get()); writing must go through Mutable(), which
+ * makes a private copy of the buffer first if it is shared with other
+ * objects. Keep the reference returned by Mutable() for a whole loop
+ * instead of calling Mutable() for each element.
+ *
+ * Different objects sharing a buffer can be read and written from
+ * different threads (a writer always detaches first). As with
+ * std::vector, one object must not be written by two threads at once.
+ *
+ * member function(s):
+ * const vector<T> &Get() const  ----  The samples (also via implicit conversion).
+ * vector<T> &Mutable()          ----  The samples, detached from other copies.
+ * bool Shared() const           ----  true if the buffer is shared with other copies.
+ * size(), empty(), begin(), end(), back(), operator[] ----  Same as const std::vector.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: copy on write, shared, buffer, vector.
+*************************************************************/
+
+template<typename T>
+class CowVector {
+
+    std::shared_ptr<std::vector<T>> p;      // nullptr: empty.
+
+    static const std::vector<T> &Empty() {
+        static const std::vector<T> ans;
+        return ans;
+    }
+
+public:
+
+    CowVector () = default;
+    CowVector (const std::vector<T> &x) : p(std::make_shared<std::vector<T>>(x)) {}
+    CowVector (std::vector<T> &&x) : p(std::make_shared<std::vector<T>>(std::move(x))) {}
+
+    CowVector &operator=(const std::vector<T> &x) {p=std::make_shared<std::vector<T>>(x);return *this;}
+    CowVector &operator=(std::vector<T> &&x) {p=std::make_shared<std::vector<T>>(std::move(x));return *this;}
+
+    const std::vector<T> &Get() const {return (p?*p:Empty());}
+    operator const std::vector<T> &() const {return Get();}
+
+    std::vector<T> &Mutable() {
+        if (!p) p=std::make_shared<std::vector<T>>();
+        else if (p.use_count()>1) p=std::make_shared<std::vector<T>>(*p);
+        else std::atomic_thread_fence(std::memory_order_acquire);  // other owners are done with it.
+        return *p;
+    }
+
+    bool Shared() const {return (p && p.use_count()>1);}
+
+    std::size_t size() const {return Get().size();}
+    bool empty() const {return Get().empty();}
+    typename std::vector<T>::const_iterator begin() const {return Get().begin();}
+    typename std::vector<T>::const_iterator end() const {return Get().end();}
+    const T &back() const {return Get().back();}
+    const T &operator[](const std::size_t &i) const {return (*p)[i];}
+};
+
+#endif
@@ -1,12 +1,13 @@
 #ifndef ASU_CROSSCORRELATION
 #define ASU_CROSSCORRELATION
+// Need sci-libs/fftw
 
-#include<iostream>
 #include<vector>
-#include<iterator>
-#include<cmath>
+#include<string>
 #include<limits>
-#include<numeric>
+#include<stdexcept>
+
+#include<CrossCorrelationEngine.hpp>
 
 /**************************************************************************
  * This C function(s) calculate Zero-normalized cross-correlationbetween x
@@ -29,6 +30,18 @@
  *    x*y[tau] = ----------------------------------------
  *                  sqrt( (sum of x^2)*(sum of y^2) )
  *
+ * The numerator is either calculated lag by lag (O(m*n)) or for all lags
+ * at once through FFT (O((m+n)log(m+n))). The method is chosen by the cost
+ * of each: FFT is used for long windows with a wide shift range, the
+ * direct sum for short windows or a narrow ShiftLimit. Both give the same
+ * result up to round-off. The direct sum removes the means once and
+ * computes four lags per pass over y, with AVX-512 or AVX2/FMA when the
+ * code is compiled for it (e.g. -march=native), plain C++ otherwise.
+ *
+ * For a sub-sample shift, refine the peak of Ans (Dump=true) with
+ * ParabolicPeak, or use EvenSampledSignal::CrossCorrelation(...,SubSample=true).
+ * To correlate one y against many x, use CrossCorrelationEngine.
+ *
  * input(s):
  * const vector<T1> &x              ----  Signal x.
  * const vector<T2> &y              ----  Signal y.
@@ -66,80 +79,21 @@
  * Shule Yu
  * Dec 28 2017
  *
- * Key words: cross-correlation.
+ * Dependence: fftw-3.
+ *
+ * Key words: cross-correlation, fft.
 **************************************************************************/
 
 template<typename T1, typename T2>
 std::pair<std::pair<int,double>,std::vector<double>> CrossCorrelation(const T1 XBegin, const T1 XEnd, const T2 YBegin, const T2 YEnd, const bool &Dump=false, const int &Flip=0, const std::pair<int,int> &ShiftLimit={std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}){
 
     // Check signal length.
-    int m=std::distance(XBegin,XEnd),n=std::distance(YBegin,YEnd);
-    if (m==0 || n==0) {
+    if (XBegin==XEnd || YBegin==YEnd) {
         throw std::runtime_error("Error in " + std::string(__func__) + ": x or y size is zero ...");
         return {};
     }
 
-    // Prepare shift limit.
-    if (ShiftLimit.first>ShiftLimit.second) {
-        throw std::runtime_error("Error in " + std::string(__func__) + ": ShiftLimit first > second ...");
-        return {};
-    }
-    int ShiftLeft=std::max(ShiftLimit.first,1-n);
-    int ShiftRight=std::min(ShiftLimit.second,m-1);
-
-
-
-    // Calculate x average and y average.
-    double avrx=std::accumulate(XBegin,XEnd,0.0)/m;
-    double avry=std::accumulate(YBegin,YEnd,0.0)/n;
-
-
-    // Denominator. (remove the deviation of the signals)
-    double xx=0,yy=0;
-    for (int i=0;i<m;++i) xx+=(XBegin[i]-avrx)*(XBegin[i]-avrx);
-    for (int i=0;i<n;++i) yy+=(YBegin[i]-avry)*(YBegin[i]-avry);
-    if ( xx==0 || yy==0 ){
-        std::cerr <<  "Warning in " << __func__ << ": x or y is zero's ..." << std::endl;
-        return {};
-    }
-    double energy=sqrt(xx*yy);
-
-    // Prepare cross-correlation trace.
-    std::vector<double> res;
-    if (Dump) res.resize(ShiftRight-ShiftLeft+1,0);
-
-    // Shifting and create cross-correlation trace.
-    double ccc=(Flip==0?0:std::numeric_limits<double>::lowest());
-    int shift,polarity=(Flip==-1?-1:1);
-
-    for (int tau=ShiftLeft;tau<=ShiftRight;++tau){
-
-        double R=0;
-
-        // Equivalently:
-        //         int xBegin=tau>0?tau:0;
-        //         int xEnd=m<(n+tau)?m:(n+tau);
-        //
-        //         for (int i=xBegin;i<xEnd;++i)
-        //             R+=(XBegin[i]-avrx)*(YBegin[i-tau]-avry)*polarity;
-
-        int yBegin=tau>0?0:-tau;
-        int yEnd=(m-tau)>n?n:m-tau;
-
-        for (int i=yBegin;i<yEnd;++i)
-            R+=(XBegin[i+tau]-avrx)*(YBegin[i]-avry)*polarity;
-
-        R/=energy;
-
-        if ( (Flip==0 && fabs(ccc)<fabs(R)) || (Flip!=0 && ccc<R) ){
-            ccc=R;
-            shift=tau;
-        }
-
-        if (Dump) res[tau-ShiftLeft]=R;
-    }
-
-    return {{shift,ccc},res};
+    return CrossCorrelationEngine(YBegin,YEnd,Flip,ShiftLimit)(XBegin,XEnd,Dump);
 }
 
 template<typename T1, typename T2>
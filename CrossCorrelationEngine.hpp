@@ -0,0 +1,304 @@
+#ifndef ASU_CROSSCORRELATIONENGINE
+#define ASU_CROSSCORRELATIONENGINE
+// Need sci-libs/fftw
+
+#include<iostream>
+#include<vector>
+#include<map>
+#include<memory>
+#include<iterator>
+#include<algorithm>
+#include<cmath>
+#include<limits>
+#include<numeric>
+#include<tuple>
+#include<mutex>
+#include<stdexcept>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include<immintrin.h>
+#endif
+
+extern "C"{
+#include<fftw3.h>
+}
+
+#include<FFTWPlanCache.hpp>
+#include<NextFFTSize.hpp>
+
+/**************************************************************************
+ * This C++ class cross-correlates one template y against many signals x.
+ * It gives the same result as CrossCorrelation(x,y,Dump,Flip,ShiftLimit)
+ * (see CrossCorrelation.hpp), but the template is prepared only once:
+ *
+ *     CrossCorrelationEngine E(y,Flip,ShiftLimit);
+ *     for (...) auto res=E(x[i]);     // may be called from many threads.
+ *
+ * The template mean, energy and its spectrum for each FFT length are
+ * computed once and shared by all calls (and all copies of the engine).
+ * FFT plans and scratch buffers come from FFTWPlanCache.
+ *
+ * constructor input(s):
+ * const vector<T> &y               ----  Template signal y (or iterators YBegin, YEnd).
+ * const int       &Flip            ----  (Optional) Flag for compare mode, default is 0. (see CrossCorrelation.hpp)
+ * const pair<int,int> &ShiftLimit  ----  (Optional) Two parameters control the range of shift, default is no limitations.
+ *
+ * member function(s):
+ * operator()(const vector<T> &x, const bool &Dump=false) const  ----  Same as CrossCorrelation(x,y,Dump,Flip,ShiftLimit).
+ *                                                                    (or iterators XBegin, XEnd)
+ * size_t Size() const                                           ----  Template length.
+ * pair<int,int> Shifts(const int &m) const                      ----  The first and last shift for a length m signal x.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Dependence: fftw-3.
+ *
+ * Key words: cross-correlation, fft, batch, template.
+**************************************************************************/
+
+namespace CrossCorrelationHidden {
+
+    // FFT length needed for lags [l,r] to be free of wrap-around.
+    inline int FFTSize(const int &m, const int &n, const int &l, const int &r){
+        return NextFFTSize(std::max(std::max(m,n),std::max(m-l,r+n)));
+    }
+
+    // rough costs in multiply-adds: the direct sum over all overlaps, against
+    // a few real transforms of length L plus the plan set-up.
+    inline bool UseFFT(const int &m, const int &n, const int &l, const int &r){
+        double Direct=0,L=FFTSize(m,n,l,r);
+        for (int tau=l;tau<=r;++tau) Direct+=std::min(n,m-tau)-std::max(0,-tau);
+        return Direct>2*L*std::log2(L)+1e5;
+    }
+
+    // s[k] = sum ( x[i+k]y[i] ), for i in [0,len), k=0,1,2,3.
+    inline void Dot4(const double *x, const double *y, const int &len, double *s){
+        int i=0;
+        double s0=0,s1=0,s2=0,s3=0;
+#if defined(__AVX512F__)
+        __m512d a0=_mm512_setzero_pd(),a1=a0,a2=a0,a3=a0;
+        for (;i+8<=len;i+=8){
+            __m512d b=_mm512_loadu_pd(y+i);
+            a0=_mm512_fmadd_pd(_mm512_loadu_pd(x+i),b,a0);
+            a1=_mm512_fmadd_pd(_mm512_loadu_pd(x+i+1),b,a1);
+            a2=_mm512_fmadd_pd(_mm512_loadu_pd(x+i+2),b,a2);
+            a3=_mm512_fmadd_pd(_mm512_loadu_pd(x+i+3),b,a3);
+        }
+        s0=_mm512_reduce_add_pd(a0);s1=_mm512_reduce_add_pd(a1);
+        s2=_mm512_reduce_add_pd(a2);s3=_mm512_reduce_add_pd(a3);
+#elif defined(__AVX2__) && defined(__FMA__)
+        __m256d a0=_mm256_setzero_pd(),a1=a0,a2=a0,a3=a0;
+        for (;i+4<=len;i+=4){
+            __m256d b=_mm256_loadu_pd(y+i);
+            a0=_mm256_fmadd_pd(_mm256_loadu_pd(x+i),b,a0);
+            a1=_mm256_fmadd_pd(_mm256_loadu_pd(x+i+1),b,a1);
+            a2=_mm256_fmadd_pd(_mm256_loadu_pd(x+i+2),b,a2);
+            a3=_mm256_fmadd_pd(_mm256_loadu_pd(x+i+3),b,a3);
+        }
+        double t[4];
+        _mm256_storeu_pd(t,_mm256_add_pd(_mm256_hadd_pd(a0,a1),_mm256_permute2f128_pd(_mm256_hadd_pd(a0,a1),_mm256_hadd_pd(a0,a1),1)));
+        s0=t[0];s1=t[1];
+        _mm256_storeu_pd(t,_mm256_add_pd(_mm256_hadd_pd(a2,a3),_mm256_permute2f128_pd(_mm256_hadd_pd(a2,a3),_mm256_hadd_pd(a2,a3),1)));
+        s2=t[0];s3=t[1];
+#endif
+        for (;i<len;++i){
+            double b=y[i];
+            s0+=x[i]*b;s1+=x[i+1]*b;s2+=x[i+2]*b;s3+=x[i+3]*b;
+        }
+        s[0]=s0;s[1]=s1;s[2]=s2;s[3]=s3;
+    }
+
+    // R[tau-l] = sum ( x[i+tau]y[i] ), for tau in [l,r].
+    inline void DirectLag(const std::vector<double> &x, const std::vector<double> &y,
+                          const int &l, const int &r, std::vector<double> &R){
+        int m=x.size(),n=y.size(),tau=l;
+
+        // y range of lag t: [max(0,-t),min(n,m-t)).
+        auto Sum=[&](const int &t, const int &b, const int &e){
+            double ans=0;
+            for (int i=b;i<e;++i) ans+=x[i+t]*y[i];
+            return ans;
+        };
+
+        // four lags at a time on their common y range, the rest one by one.
+        for (;tau+3<=r;tau+=4){
+            int b=std::max(0,-tau),e=std::min(n,m-tau-3);
+            if (b<e){
+                double s[4];
+                Dot4(&x[b+tau],&y[b],e-b,s);
+                for (int k=0;k<4;++k){
+                    int t=tau+k;
+                    R[t-l]=s[k]+Sum(t,std::max(0,-t),b)+Sum(t,e,std::min(n,m-t));
+                }
+            }
+            else
+                for (int t=tau;t<tau+4;++t) R[t-l]=Sum(t,std::max(0,-t),std::min(n,m-t));
+        }
+        for (;tau<=r;++tau) R[tau-l]=Sum(tau,std::max(0,-tau),std::min(n,m-tau));
+    }
+
+    // template spectrum of one FFT length.
+    struct Spectrum {
+        int L=0;
+        fftw_complex *Y=nullptr;
+
+        Spectrum () = default;
+        Spectrum (const Spectrum &) = delete;
+        Spectrum &operator=(const Spectrum &) = delete;
+
+        ~Spectrum() {fftw_free(Y);}
+    };
+}
+
+class CrossCorrelationEngine {
+
+    struct Cache {
+        std::mutex lock;
+        std::map<int,std::shared_ptr<const CrossCorrelationHidden::Spectrum>> spectra;
+    };
+
+    std::vector<double> y;                      // template, mean removed, flipped.
+    double yy=0;
+    int Flip=0;
+    std::pair<int,int> ShiftLimit;
+    std::shared_ptr<Cache> cache;
+
+    std::shared_ptr<const CrossCorrelationHidden::Spectrum> GetSpectrum(const int &L) const {
+        using namespace CrossCorrelationHidden;
+        std::lock_guard<std::mutex> lock(cache->lock);
+        auto &ans=cache->spectra[L];
+        if (ans) return ans;
+
+        auto p=std::make_shared<Spectrum>();
+        p->L=L;
+        p->Y=(fftw_complex *)fftw_malloc((L/2+1)*sizeof(fftw_complex));
+        if (p->Y==nullptr)
+            throw std::runtime_error("Error in CrossCorrelation: fftw_malloc failed ...");
+
+        double *In=FFTWPlanCache::Real(L);
+        std::copy(y.begin(),y.end(),In);
+        std::fill(In+y.size(),In+L,0.0);
+        fftw_execute_dft_r2c(FFTWPlanCache::R2C(L),In,p->Y);
+
+        ans=p;
+        return ans;
+    }
+
+    // Same as DirectLag, using X(f)*conj(Y(f)).
+    void FFTLag(const std::vector<double> &x, const int &l, const int &r, std::vector<double> &R) const {
+        using namespace CrossCorrelationHidden;
+        int m=x.size(),L=FFTSize(m,Size(),l,r),K=L/2+1;
+
+        auto p=GetSpectrum(L);
+        double *In=FFTWPlanCache::Real(L);
+        fftw_complex *X=FFTWPlanCache::Complex(K);
+
+        std::copy(x.begin(),x.end(),In);
+        std::fill(In+m,In+L,0.0);
+        fftw_execute_dft_r2c(FFTWPlanCache::R2C(L),In,X);
+
+        for (int k=0;k<K;++k){
+            double a=X[k][0],b=X[k][1],c=p->Y[k][0],d=p->Y[k][1];
+            X[k][0]=a*c+b*d;
+            X[k][1]=b*c-a*d;
+        }
+        fftw_execute_dft_c2r(FFTWPlanCache::C2R(L),X,In);
+
+        // negative lags are wrapped to the end.
+        for (int tau=l;tau<=r;++tau)
+            R[tau-l]=In[tau<0?tau+L:tau]/L;
+    }
+
+public:
+
+    template<typename T>
+    CrossCorrelationEngine (const T YBegin, const T YEnd, const int &flip=0,
+                            const std::pair<int,int> &shiftLimit={std::numeric_limits<int>::min(),std::numeric_limits<int>::max()})
+        : Flip(flip), ShiftLimit(shiftLimit), cache(std::make_shared<Cache>()) {
+
+        int n=std::distance(YBegin,YEnd);
+        if (n==0)
+            throw std::runtime_error("Error in CrossCorrelation: x or y size is zero ...");
+        if (ShiftLimit.first>ShiftLimit.second)
+            throw std::runtime_error("Error in CrossCorrelation: ShiftLimit first > second ...");
+
+        // Remove the average (and flip y) once.
+        double avry=std::accumulate(YBegin,YEnd,0.0)/n;
+        int polarity=(Flip==-1?-1:1);
+        y.resize(n);
+        for (int i=0;i<n;++i) y[i]=(YBegin[i]-avry)*polarity;
+        for (int i=0;i<n;++i) yy+=y[i]*y[i];
+    }
+
+    template<typename T>
+    CrossCorrelationEngine (const std::vector<T> &Y, const int &flip=0,
+                            const std::pair<int,int> &shiftLimit={std::numeric_limits<int>::min(),std::numeric_limits<int>::max()})
+        : CrossCorrelationEngine(Y.begin(),Y.end(),flip,shiftLimit) {}
+
+    std::size_t Size() const {return y.size();}
+
+    std::pair<int,int> Shifts(const int &m) const {
+        return {std::max(ShiftLimit.first,1-(int)Size()),std::min(ShiftLimit.second,m-1)};
+    }
+
+    template<typename T>
+    std::pair<std::pair<int,double>,std::vector<double>> operator()(const T XBegin, const T XEnd, const bool &Dump=false) const {
+
+        // Check signal length.
+        int m=std::distance(XBegin,XEnd),n=Size();
+        if (m==0)
+            throw std::runtime_error("Error in CrossCorrelation: x or y size is zero ...");
+
+        // Prepare shift limit.
+        int ShiftLeft,ShiftRight;
+        std::tie(ShiftLeft,ShiftRight)=Shifts(m);
+
+        // Remove x average.
+        double avrx=std::accumulate(XBegin,XEnd,0.0)/m;
+        std::vector<double> x(m);
+        for (int i=0;i<m;++i) x[i]=XBegin[i]-avrx;
+
+        // Denominator. (remove the deviation of the signals)
+        double xx=0;
+        for (int i=0;i<m;++i) xx+=x[i]*x[i];
+        if ( xx==0 || yy==0 ){
+            std::cerr <<  "Warning in CrossCorrelation: x or y is zero's ..." << std::endl;
+            return {};
+        }
+        double energy=sqrt(xx*yy);
+
+        // Numerator for each shift.
+        std::vector<double> res(std::max(0,ShiftRight-ShiftLeft+1),0);
+        if (!res.empty() && CrossCorrelationHidden::UseFFT(m,n,ShiftLeft,ShiftRight))
+            FFTLag(x,ShiftLeft,ShiftRight,res);
+        else
+            CrossCorrelationHidden::DirectLag(x,y,ShiftLeft,ShiftRight,res);
+
+        // Create cross-correlation trace. (start from the first lag)
+        double ccc=(Flip==0?0:std::numeric_limits<double>::lowest());
+        int shift=ShiftLeft;
+
+        for (int tau=ShiftLeft;tau<=ShiftRight;++tau){
+
+            double R=res[tau-ShiftLeft]/energy;
+
+            if ( tau==ShiftLeft || (Flip==0 && fabs(ccc)<fabs(R)) || (Flip!=0 && ccc<R) ){
+                ccc=R;
+                shift=tau;
+            }
+
+            res[tau-ShiftLeft]=R;
+        }
+
+        if (!Dump) res.clear();
+        return {{shift,ccc},res};
+    }
+
+    template<typename T>
+    std::pair<std::pair<int,double>,std::vector<double>> operator()(const std::vector<T> &x, const bool &Dump=false) const {
+        return (*this)(x.begin(),x.end(),Dump);
+    }
+};
+
+#endif
@@ -10,10 +10,20 @@
 #include<cmath>
 
 #include<Amplitude.hpp>
+#include<CowVector.hpp>
 #include<SortWithIndex.hpp>
 #include<ReorderUseIndex.hpp>
 
-class DigitalSignal{
+// T is the sample type (amp). Time, scales and results are always double.
+// DigitalSignal (double samples) and FloatDigitalSignal (float samples,
+// half the memory) are defined at the end of the class declaration.
+//
+// Samples are copy-on-write (see CowVector.hpp): copies of a signal share
+// the samples until one of them changes its samples. Copies which only
+// change time, peak, tag ... don't copy the samples. Member functions
+// changing the samples use amp.Mutable().
+template<typename T>
+class BasicDigitalSignal{
 
 private:   // private part never get inherited.
 
@@ -25,12 +35,16 @@ protected: // inherit mode is "private"               --> "private".
            // inherit mode is "protected" or "public" --> "protected".
 
 
-    std::vector<double> amp;
+    CowVector<T> amp;
     std::size_t peak;
     std::string filename;
     int tag;
     double amp_multiplier;
 
+    // replace samples (converted if the new samples are not of type T).
+    void AssignAmp(std::vector<T> &&x) {amp=std::move(x);}
+    template<typename U> void AssignAmp(const std::vector<U> &x) {amp=std::vector<T> (x.begin(),x.end());}
+
 
 public:    // inherit mode is "private"   --> "private".
            // inherit mode is "protected" --> "protected".
@@ -38,11 +52,14 @@ public:    // inherit mode is "private"   --> "private".
 
 
     // Constructor/Destructors.
-    DigitalSignal ();
-    DigitalSignal (const DigitalSignal &item) = default;
-    DigitalSignal (const std::string &infile);                         // Read from a 2-column file.
-    DigitalSignal (const std::vector<double> &ti, const std::vector<double> &am);   // By 2 vectors.
-    virtual ~DigitalSignal () = default;                // Base class destructor need to be virtual.
+    BasicDigitalSignal ();
+    BasicDigitalSignal (const BasicDigitalSignal &item) = default;
+    BasicDigitalSignal (BasicDigitalSignal &&item) = default;
+    BasicDigitalSignal (const std::string &infile);                         // Read from a 2-column file.
+    BasicDigitalSignal (const std::vector<double> &ti, const std::vector<T> &am);   // By 2 vectors.
+    virtual ~BasicDigitalSignal () = default;                // Base class destructor need to be virtual.
+    BasicDigitalSignal &operator=(const BasicDigitalSignal &item) = default;
+    BasicDigitalSignal &operator=(BasicDigitalSignal &&item) = default;
 
 
     // Declaration of virtual functions/operators. They will be overwritten in drived class.
@@ -60,7 +77,7 @@ public:    // inherit mode is "private"   --> "private".
         if (t1<BeginTime() || t2>EndTime()) return false;
         else return true;
     }
-    virtual void Clear() {*this=DigitalSignal ();}
+    virtual void Clear() {*this=BasicDigitalSignal ();}
     virtual double EndTime() const {return (GetTime().empty()?0.0/0.0:GetTime().back());}
     virtual std::vector<double> GetTime() const {return time;}
     virtual double PeakAmp() const {return (GetAmp().empty()?0.0/0.0:GetAmp()[GetPeak()]);}
@@ -92,7 +109,7 @@ public:    // inherit mode is "private"   --> "private".
     // you need to guarantee they behaves well for all derived classes.
     // Because they are intended unchangeable, only protected and public memebers can appear here(?)
 
-    const std::vector<double> &GetAmp() const {return amp;}
+    const std::vector<T> &GetAmp() const {return amp.Get();}
     double GetAmpMultiplier() const {return amp_multiplier;}
     double GetTag() const {return tag;}
     const std::string &GetFileName() const {return filename;}
@@ -114,22 +131,24 @@ public:    // inherit mode is "private"   --> "private".
     std::size_t Size() const {return GetAmp().size();}
 
     std::pair<std::size_t,std::size_t> FindAmplevel(const double &level=0.5) const;
-    std::vector<double> GetAmp(const double &t1, const double &t2) const ;
+    std::vector<T> GetAmp(const double &t1, const double &t2) const ;
     void Mask(const double &t1=-std::numeric_limits<double>::max(), const double &t2=std::numeric_limits<double>::max());
     void NormalizeToWindow(const double &t1, const double &t2);
 
-    DigitalSignal &operator+=(const double &a){
-        for (std::size_t i=0;i<Size();++i) amp[i]+=a;
+    BasicDigitalSignal &operator+=(const double &a){
+        auto &x=amp.Mutable();
+        for (std::size_t i=0;i<Size();++i) x[i]+=a;
         return *this;
     }
-    DigitalSignal &operator*=(const double &a){
-        for (std::size_t i=0;i<Size();++i) amp[i]*=a;
+    BasicDigitalSignal &operator*=(const double &a){
+        auto &x=amp.Mutable();
+        for (std::size_t i=0;i<Size();++i) x[i]*=a;
         if (a!=0) amp_multiplier/=a;
         else amp_multiplier=1.0/0.0;
         return *this;
     }
-    DigitalSignal &operator-=(const double &a){*this+=(-a);return *this;}
-    DigitalSignal &operator/=(const double &a){
+    BasicDigitalSignal &operator-=(const double &a){*this+=(-a);return *this;}
+    BasicDigitalSignal &operator/=(const double &a){
 //         if (a==0) throw std::runtime_error("Dividing amplitudes with zero.");
         if (a>0) *this*=(1.0/a);
         return *this;
@@ -139,19 +158,24 @@ public:    // inherit mode is "private"   --> "private".
     // declaration of non-member class/function/operators as friend.
     // Input operator >> need access to the private/protected parts of this class,
     // therefore it needs to be friend.
-    friend std::istream &operator>>(std::istream &is, DigitalSignal &item);
+    template<typename U> friend std::istream &operator>>(std::istream &is, BasicDigitalSignal<U> &item);
 
 }; // End of class declaration.
 
+typedef BasicDigitalSignal<double> DigitalSignal;
+typedef BasicDigitalSignal<float> FloatDigitalSignal;
+
 // Constructors/Destructors definition.
-DigitalSignal::DigitalSignal () {
+template<typename T>
+BasicDigitalSignal<T>::BasicDigitalSignal () {
     peak=-1;
     amp_multiplier=1;
     tag=0;
     filename="";
 }
 
-DigitalSignal::DigitalSignal (const std::string &infile) {
+template<typename T>
+BasicDigitalSignal<T>::BasicDigitalSignal (const std::string &infile) {
     std::ifstream fpin(infile);
     fpin >> *this;
     fpin.close();
@@ -159,7 +183,8 @@ DigitalSignal::DigitalSignal (const std::string &infile) {
     filename=infile;
 }
 
-DigitalSignal::DigitalSignal (const std::vector<double> &ti, const std::vector<double> &am) {
+template<typename T>
+BasicDigitalSignal<T>::BasicDigitalSignal (const std::vector<double> &ti, const std::vector<T> &am) {
     time=ti;
     amp=am;
     peak=-1;
@@ -170,7 +195,8 @@ DigitalSignal::DigitalSignal (const std::vector<double> &ti, const std::vector<d
 
 
 // Member function/operators definitions.
-bool DigitalSignal::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS){
+template<typename T>
+bool BasicDigitalSignal<T>::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS){
 
     if (t1<BeginTime()) return false;
     std::size_t d1=LocateTime(t1);
@@ -179,9 +205,9 @@ bool DigitalSignal::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS)
     // Cut.
 
     std::vector<double> time2(GetTime().begin()+d1,GetTime().begin()+d1+NPTS);
-    std::vector<double> amp2(GetAmp().begin()+d1,GetAmp().begin()+d1+NPTS);
+    std::vector<T> amp2(GetAmp().begin()+d1,GetAmp().begin()+d1+NPTS);
     std::swap(time,time2);
-    std::swap(amp,amp2);
+    amp=std::move(amp2);
 
     if (d1<=GetPeak() && GetPeak()<d1+NPTS) peak-=d1;
     else peak=-1;
@@ -191,7 +217,8 @@ bool DigitalSignal::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS)
 
 // Cut the data within a window and return true.
 // If cut failed, do nothing and return false.
-bool DigitalSignal::CheckAndCutToWindow(const double &t1, const double &t2){
+template<typename T>
+bool BasicDigitalSignal<T>::CheckAndCutToWindow(const double &t1, const double &t2){
 
     if (!CheckWindow(t1,t2)) return false;
 
@@ -200,9 +227,9 @@ bool DigitalSignal::CheckAndCutToWindow(const double &t1, const double &t2){
     ++d2;
 
     std::vector<double> time2(GetTime().begin()+d1,GetTime().begin()+d2);
-    std::vector<double> amp2(GetAmp().begin()+d1,GetAmp().begin()+d2);
+    std::vector<T> amp2(GetAmp().begin()+d1,GetAmp().begin()+d2);
     std::swap(time,time2);
-    std::swap(amp,amp2);
+    amp=std::move(amp2);
 
     if (GetPeak()<d2 && GetPeak()>=d1) peak-=d1;
     else peak=-1;
@@ -211,7 +238,8 @@ bool DigitalSignal::CheckAndCutToWindow(const double &t1, const double &t2){
 }
 
 // Find the position of max|amp| around given time.
-void DigitalSignal::FindPeakAround(const double &t, const double &w, const bool &positiveOnly){
+template<typename T>
+void BasicDigitalSignal<T>::FindPeakAround(const double &t, const double &w, const bool &positiveOnly){
 
     if (w<0) return;
     if (t+w<BeginTime() || t-w>EndTime()) return;
@@ -235,17 +263,20 @@ void DigitalSignal::FindPeakAround(const double &t, const double &w, const bool
 }
 
 // cos (-pi,pi) shaped taper at two ends.
-void DigitalSignal::HannTaper(const double &wl){
+template<typename T>
+void BasicDigitalSignal<T>::HannTaper(const double &wl){
     if (wl*2>SignalDuration())
         throw std::runtime_error("Hanning window too wide.");
+    auto &x=amp.Mutable();
     for (std::size_t i=0;i<Size();++i){
         double len=std::min(GetTime()[i]-GetTime()[0],GetTime().back()-GetTime()[i]);
-        if (len<wl) amp[i]*=0.5-0.5*cos(len/wl*M_PI);
+        if (len<wl) x[i]*=0.5-0.5*cos(len/wl*M_PI);
     }
 }
 
 // if requested time outside of signal range, return 0 or Size()-1.
-std::size_t DigitalSignal::LocateTime(const double &t) const {
+template<typename T>
+std::size_t BasicDigitalSignal<T>::LocateTime(const double &t) const {
     if (t<BeginTime() || t>EndTime()) {
         //std::cerr <<  "Warning in " << __func__
         //          << ": request time location outside of the signal ..." << std::endl;
@@ -259,7 +290,8 @@ std::size_t DigitalSignal::LocateTime(const double &t) const {
 }
 
 // Print metadata.
-void DigitalSignal::PrintInfo() const{
+template<typename T>
+void BasicDigitalSignal<T>::PrintInfo() const{
     std::cout << "File name  : " << GetFileName() << '\n';
     std::cout << "Duration   : " << SignalDuration() << '\n';
     std::cout << "NPTS       : " << Size() << '\n';
@@ -272,7 +304,8 @@ void DigitalSignal::PrintInfo() const{
 }
 
 // remove drift and DC.
-std::pair<double,double> DigitalSignal::RemoveTrend(){
+template<typename T>
+std::pair<double,double> BasicDigitalSignal<T>::RemoveTrend(){
 
     if (Size()<=1) return {0,0};
 
@@ -290,14 +323,16 @@ std::pair<double,double> DigitalSignal::RemoveTrend(){
     double intercept=sumy/Size()-slope*avx;
 
     // remove the trend and average for input data points.
+    auto &x=amp.Mutable();
     for (std::size_t i=0;i<Size();++i)
-        amp[i]-=(intercept+GetTime()[i]*slope);
+        x[i]-=(intercept+GetTime()[i]*slope);
 
     return {slope,intercept};
 }
 
 // area under the curve, with different modes according to different operators.
-double DigitalSignal::SumArea(const double &t1, const double &t2, const size_t &mode) const{
+template<typename T>
+double BasicDigitalSignal<T>::SumArea(const double &t1, const double &t2, const size_t &mode) const{
     if (t1>t2) throw std::runtime_error("In SumArea, t2<t1 ...");
     std::size_t p1=LocateTime(t1),p2=LocateTime(t2);
     if (p1==p2) return 0;
@@ -328,18 +363,21 @@ double DigitalSignal::SumArea(const double &t1, const double &t2, const size_t &
 }
 
 // taper window half-length is wl, zero half-length is zl.
-void DigitalSignal::ZeroOutHannTaper(const double &wl, const double &zl){
+template<typename T>
+void BasicDigitalSignal<T>::ZeroOutHannTaper(const double &wl, const double &zl){
     if ((wl+zl)*2>SignalDuration()) throw std::runtime_error("ZeroOutHanning window too wide.");
+    auto &x=amp.Mutable();
     for (std::size_t i=0;i<Size();++i){
         double len=std::min(GetTime()[i]-GetTime()[0],GetTime().back()-GetTime()[i]);
-        if (len<zl) amp[i]=0;
-        else if (len<zl+wl) amp[i]*=0.5-0.5*cos((len-zl)/wl*M_PI);
+        if (len<zl) x[i]=0;
+        else if (len<zl+wl) x[i]*=0.5-0.5*cos((len-zl)/wl*M_PI);
     }
 }
 
 // Find the amplitude level width move away from peak.
 // Need to define peak.
-std::pair<std::size_t,std::size_t> DigitalSignal::FindAmplevel(const double &level) const {
+template<typename T>
+std::pair<std::size_t,std::size_t> BasicDigitalSignal<T>::FindAmplevel(const double &level) const {
 
     if (level<0 || level>=1)
         throw std::runtime_error("Amplitude level is not in [0,1) ...");
@@ -364,23 +402,27 @@ std::pair<std::size_t,std::size_t> DigitalSignal::FindAmplevel(const double &lev
     return ans;
 }
 
-std::vector<double> DigitalSignal::GetAmp(const double &t1, const double &t2) const {
+template<typename T>
+std::vector<T> BasicDigitalSignal<T>::GetAmp(const double &t1, const double &t2) const {
     std::size_t p1=LocateTime(t1),p2=LocateTime(t2);
     if (p1>p2) return {};
-    else return std::vector<double> (GetAmp().begin()+p1,GetAmp().begin()+p2+1);
+    else return std::vector<T> (GetAmp().begin()+p1,GetAmp().begin()+p2+1);
 }
 
-void DigitalSignal::Mask(const double &t1, const double &t2){
+template<typename T>
+void BasicDigitalSignal<T>::Mask(const double &t1, const double &t2){
     std::size_t p1=LocateTime(t1),p2=LocateTime(t2);
+    auto &x=amp.Mutable();
     for (std::size_t i=p1;i<=p2;++i)
-        amp[i]=0;
+        x[i]=0;
     return;
 }
 
-void DigitalSignal::NormalizeToWindow(const double &t1, const double &t2){
+template<typename T>
+void BasicDigitalSignal<T>::NormalizeToWindow(const double &t1, const double &t2){
     size_t w=LocateTime(t1),v=LocateTime(t2);
     double maxAmp=-std::numeric_limits<double>::max();
-    for (size_t i=w;i<v;++i) maxAmp=std::max(maxAmp,fabs(GetAmp()[i]));
+    for (size_t i=w;i<v;++i) maxAmp=std::max(maxAmp,(double)fabs(GetAmp()[i]));
     *this/=maxAmp;
     return;
 }
@@ -392,21 +434,23 @@ End of member function/operator definitions. -----------------------------------
 // Non-member functions/operators.
 
 // Overload operator ">>" to read a signal from a two-columned input (stdin/file/etc.)
-std::istream &operator>>(std::istream &is, DigitalSignal &item){
+template<typename T>
+std::istream &operator>>(std::istream &is, BasicDigitalSignal<T> &item){
 
     item.Clear();
     double x,y;
 
+    auto &amp=item.amp.Mutable();
     while (is >> x >> y){                                      // to ensure amp.size()==time.size().
         item.time.push_back(x);
-        item.amp.push_back(y);
+        amp.push_back(y);
     }
 
     // Sort the time into ascending order.
 
     if (!std::is_sorted(item.GetTime().begin(),item.GetTime().end())) {    // if not weak ascending.
         auto res=::SortWithIndex(item.time.begin(),item.time.end());
-        ::ReorderUseIndex(item.amp.begin(),item.amp.end(),res);
+        ::ReorderUseIndex(amp.begin(),amp.end(),res);
     }
 
     auto cmp=[](const double &a, const double &b){return a<=b;};     // strict ascending comparator.
@@ -436,7 +480,8 @@ std::istream &operator>>(std::istream &is, DigitalSignal &item){
 
 // Overload operator "<<" to print a signal in a two-columned format.
 // Customize this section code to define other printing format.
-std::ostream &operator<<(std::ostream &os, const DigitalSignal &item){
+template<typename T>
+std::ostream &operator<<(std::ostream &os, const BasicDigitalSignal<T> &item){
 
     /*
 
@@ -462,34 +507,41 @@ std::ostream &operator<<(std::ostream &os, const DigitalSignal &item){
 }
 
 // Overload operator "+,-" to ShiftDC.
-DigitalSignal operator+(const DigitalSignal &item,const double &a){
-    DigitalSignal ans(item);
+template<typename T>
+BasicDigitalSignal<T> operator+(const BasicDigitalSignal<T> &item,const double &a){
+    BasicDigitalSignal<T> ans(item);
     ans+=a;
     return ans;
 }
-DigitalSignal operator+(const double &a,const DigitalSignal &item){
+template<typename T>
+BasicDigitalSignal<T> operator+(const double &a,const BasicDigitalSignal<T> &item){
     return item+a;
 }
-DigitalSignal operator-(const DigitalSignal &item,const double &a){
+template<typename T>
+BasicDigitalSignal<T> operator-(const BasicDigitalSignal<T> &item,const double &a){
     return item+(-a);
 }
 
 // Overload operator "*,/" to Scale.
-DigitalSignal operator*(const DigitalSignal &item,const double &a){
-    DigitalSignal ans(item);
+template<typename T>
+BasicDigitalSignal<T> operator*(const BasicDigitalSignal<T> &item,const double &a){
+    BasicDigitalSignal<T> ans(item);
     ans*=a;
     return ans;
 }
-DigitalSignal operator*(const double &a,const DigitalSignal &item){
+template<typename T>
+BasicDigitalSignal<T> operator*(const double &a,const BasicDigitalSignal<T> &item){
     return item*a;
 }
-DigitalSignal operator/(const DigitalSignal &item,const double &a){
-    DigitalSignal ans(item);
+template<typename T>
+BasicDigitalSignal<T> operator/(const BasicDigitalSignal<T> &item,const double &a){
+    BasicDigitalSignal<T> ans(item);
     ans/=a;
     return ans;
 }
 
-void DigitalSignal::OutputToFile(const std::string &s) const {
+template<typename T>
+void BasicDigitalSignal<T>::OutputToFile(const std::string &s) const {
     std::ofstream fpout(s);
     fpout << (*this) << std::endl;
     fpout.close();
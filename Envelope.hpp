@@ -5,13 +5,14 @@
 #include<vector>
 #include<cmath>
 
-#include<ShiftPhase.hpp>
+#include<AnalyticSignal.hpp>
 
 /**************************************************************
  * This C++ template calculate the envelope of the input trace.
  *
  * First make a Hilbert transform of input: y=Hilbert(x).
  * Then calculate the envelope as: z=sqrt(x^2+y^2).
+ * (See AnalyticSignal.hpp to get y and the instantaneous phase as well.)
  *
  * input(s):
  * const vector<T> &x  ----  Input signal.
@@ -32,14 +33,7 @@ std::vector<double> Envelope(const std::vector<T> &x){
 
     if (x.empty()) return {};
 
-    // Find Hilbert.
-    auto ans=ShiftPhase(x,-90);
-
-    // Find Envelope.
-    for (std::size_t i=0;i<x.size();++i)
-        ans[i]=sqrt(ans[i]*ans[i]+x[i]*x[i]);
-
-    return ans;
+    return AnalyticSignal(x).Envelope;
 }
 
 #endif
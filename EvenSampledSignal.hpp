@@ -1,6 +1,8 @@
 #ifndef ASU_EVENSAMPLEDSIGNAL
 #define ASU_EVENSAMPLEDSIGNAL
 
+#include<map>
+#include<array>
 #include<vector>
 #include<cmath>
 #include<string>
@@ -10,10 +12,12 @@
 
 #include<AvrStd.hpp>
 #include<Butterworth.hpp>
+#include<ButterworthBatch.hpp>
 #include<CompareSignal.hpp>
 #include<Convolve.hpp>
 #include<CreateGrid.hpp>
 #include<CrossCorrelation.hpp>
+#include<CrossCorrelationEngine.hpp>
 #include<DigitalSignal.hpp>
 #include<Diff.hpp>
 #include<FFT.hpp>
@@ -21,6 +25,7 @@
 #include<HannTaper.hpp>
 #include<IFFT.hpp>
 #include<Interpolate.hpp>
+#include<ParabolicPeak.hpp>
 #include<RemoveTrend.hpp>
 #include<SimpsonRule.hpp>
 #include<SNR.hpp>
@@ -28,7 +33,11 @@
 #include<TstarOperator.hpp>
 #include<WaterLevelDecon.hpp>
 
-class EvenSampledSignal : public DigitalSignal {
+// T is the sample type, see DigitalSignal.hpp.
+// EvenSampledSignal (double samples) and FloatEvenSampledSignal (float samples)
+// are defined at the end of the class declaration.
+template<typename T>
+class BasicEvenSampledSignal : public BasicDigitalSignal<T> {
 
 private:
 
@@ -43,28 +52,49 @@ protected:
 
 /*     protected members inherited from DigitalSignal.
 
-//     std::vector<double> amp;
+//     CowVector<T> amp;
 //     std::size_t peak;
 //     std::string filename;
 //     double amp_multiplier;
                                               */
+    // base class is a template: make inherited names visible.
+    using BasicDigitalSignal<T>::amp;
+    using BasicDigitalSignal<T>::peak;
+    using BasicDigitalSignal<T>::filename;
+    using BasicDigitalSignal<T>::amp_multiplier;
+    using BasicDigitalSignal<T>::AssignAmp;
+
     double delta=0,begin_time=0;
 
-    void AddStripSignal(const EvenSampledSignal &s2, const double &dt=0, const bool &flag=true);
+    void AddStripSignal(const BasicEvenSampledSignal &s2, const double &dt=0, const bool &flag=true);
 
 public:
 
+    using BasicDigitalSignal<T>::FindAmplevel;
+    using BasicDigitalSignal<T>::GetAmp;
+    using BasicDigitalSignal<T>::GetAmpMultiplier;
+    using BasicDigitalSignal<T>::GetFileName;
+    using BasicDigitalSignal<T>::GetPeak;
+    using BasicDigitalSignal<T>::GetTag;
+    using BasicDigitalSignal<T>::Size;
+
     // Constructor/Destructors.
-    EvenSampledSignal ();
-    EvenSampledSignal (const std::string &infile);                                 // 2-column file.
-    EvenSampledSignal (const std::string &infile,                                  // 1-column file.
+    BasicEvenSampledSignal ();
+    BasicEvenSampledSignal (const std::string &infile);                                 // 2-column file.
+    BasicEvenSampledSignal (const std::string &infile,                                  // 1-column file.
                        const double &dt, const double &bt=0);
-    EvenSampledSignal (const DigitalSignal &item, const double &dt);
-    EvenSampledSignal (const EvenSampledSignal &item) = default;
-    EvenSampledSignal (const EvenSampledSignal &item, const double &dt);
-    template<typename T> EvenSampledSignal (const std::vector<T> &item, const double &dt,
+    BasicEvenSampledSignal (const BasicDigitalSignal<T> &item, const double &dt);
+    BasicEvenSampledSignal (const BasicEvenSampledSignal &item) = default;
+    BasicEvenSampledSignal (BasicEvenSampledSignal &&item) = default;
+    BasicEvenSampledSignal (const BasicEvenSampledSignal &item, const double &dt);
+    template<typename U> BasicEvenSampledSignal (const std::vector<U> &item, const double &dt,
                                             const double &bt=0, const std::string &infile="");
-    ~EvenSampledSignal () = default;
+    BasicEvenSampledSignal (std::vector<T> &&item, const double &dt,               // take over samples.
+                       const double &bt=0, const std::string &infile="");
+    template<typename U> explicit BasicEvenSampledSignal (const BasicEvenSampledSignal<U> &item);  // float <-> double.
+    ~BasicEvenSampledSignal () = default;
+    BasicEvenSampledSignal &operator=(const BasicEvenSampledSignal &item) = default;
+    BasicEvenSampledSignal &operator=(BasicEvenSampledSignal &&item) = default;
 
     // Override functions/operators declarations.
 
@@ -79,7 +109,7 @@ public:
         if (t1<BeginTime() || t2>EndTime()) return false;
         else return true;
     }
-    void Clear() override {*this=EvenSampledSignal ();}
+    void Clear() override {*this=BasicEvenSampledSignal ();}
     double EndTime() const override final {return BeginTime()+SignalDuration();}
     double PeakAmp() const override final {return GetAmp()[GetPeak()];}
     double PeakTime() const override final {return BeginTime()+GetPeak()*GetDelta();}
@@ -111,53 +141,66 @@ public:
     double GetDelta() const {return delta;}
 
     double AbsIntegral() const;
-    void AddSignal(const EvenSampledSignal &s2, const double &dt=0);
+    void AddSignal(const BasicEvenSampledSignal &s2, const double &dt=0);
     void Butterworth(const double &f1, const double &f2, const int &order=2, const int &passes=2);
-    SignalCompareResults CompareSignal(const EvenSampledSignal &S2,
+    static void Butterworth(const std::vector<BasicEvenSampledSignal *> &S, const double &f1, const double &f2,
+                            const int &order=2, const int &passes=2);   // filter many signals together.
+    SignalCompareResults CompareSignal(const BasicEvenSampledSignal &S2,
                                        const double &t1=-5, const double &t2=5, const double &AmpLevel=0.1) const;
+    template<typename U>
     std::pair<double,double> CrossCorrelation(const double &t1, const double &t2,
-                                              const EvenSampledSignal &S2, const double &h1, const double &h2,
+                                              const BasicEvenSampledSignal<U> &S2, const double &h1, const double &h2,
                                               const int &Flip=0, const std::pair<int,int> &ShiftLimit=
-                                              {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}) const;
-    void Convolve(const EvenSampledSignal &item);
+                                              {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                                              const bool &SubSample=false) const;
+    std::pair<double,double> CrossCorrelation(const double &t1, const double &t2, const CrossCorrelationEngine &E,
+                                              const bool &SubSample=false) const;
+    void Convolve(const BasicEvenSampledSignal &item);
     void Diff();
-    std::pair<EvenSampledSignal,EvenSampledSignal> FFT(const bool &ReturnAmpAndPhase=true) const;
+    std::pair<BasicEvenSampledSignal,BasicEvenSampledSignal> FFT(const bool &ReturnAmpAndPhase=true) const;
     void FlipReverseSum(const double &t);
-    void GaussianBlur(const double &sigma=1);
+    void GaussianBlur(const double &sigma=1, const bool &Recursive=false);
     void Integrate();
     void Interpolate(const double &dt);
     double SNR(const double &nt1, const double &nt2, const double &st1, const double &st2) const;
-    EvenSampledSignal Stretch(const double &h=1) const;
-    EvenSampledSignal StretchToFit(const EvenSampledSignal &s, const double &t1, const double &t2,
+    std::vector<double> SNR(const std::vector<std::array<double,4>> &windows) const;   // {nt1,nt2,st1,st2} each.
+    BasicEvenSampledSignal Stretch(const double &h=1) const;
+    BasicEvenSampledSignal StretchToFit(const BasicEvenSampledSignal &s, const double &t1, const double &t2,
                                    const double &h1, const double &h2, const double &ampLevel=0.25,
                                    const bool &adaptive=false, const std::size_t method=0) const ;
-    EvenSampledSignal StretchToFitHalfWidth(const EvenSampledSignal &s) const;
-    void StripSignal(const EvenSampledSignal &s2, const double &dt=0);
-    EvenSampledSignal Tstar(const double &ts, const double &tol=1e-3) const;
-    void WaterLevelDecon(const EvenSampledSignal &source, const double &wl=0.1);
+    BasicEvenSampledSignal StretchToFitHalfWidth(const BasicEvenSampledSignal &s) const;
+    void StripSignal(const BasicEvenSampledSignal &s2, const double &dt=0);
+    BasicEvenSampledSignal Tstar(const double &ts, const double &tol=1e-3) const;
+    void WaterLevelDecon(const BasicEvenSampledSignal &source, const double &wl=0.1);
     // notice operator+=, operator-= is overloaded,
     // need "using" to make the DigitalSignal version visible.
-    using DigitalSignal::operator+=;
-    using DigitalSignal::operator-=;
-    EvenSampledSignal &operator+=(const EvenSampledSignal &item);
-    EvenSampledSignal &operator-=(const EvenSampledSignal &item);
+    using BasicDigitalSignal<T>::operator+=;
+    using BasicDigitalSignal<T>::operator-=;
+    // item can have a different sample type (e.g. stack float signals in double).
+    template<typename U> BasicEvenSampledSignal &operator+=(const BasicEvenSampledSignal<U> &item);
+    template<typename U> BasicEvenSampledSignal &operator-=(const BasicEvenSampledSignal<U> &item);
 
     // declaration of non-member class/function/operators as friend.
     // Input operator >> need access to the private/protected parts of this class,
     // therefore it needs to be friend.
-    friend std::istream &operator>>(std::istream &is, EvenSampledSignal &item);
+    template<typename U> friend std::istream &operator>>(std::istream &is, BasicEvenSampledSignal<U> &item);
 
 }; // End of class declaration.
 
+typedef BasicEvenSampledSignal<double> EvenSampledSignal;
+typedef BasicEvenSampledSignal<float> FloatEvenSampledSignal;
+
 // Constructors/Destructors definition.
-EvenSampledSignal::EvenSampledSignal () {
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal () {
     // The default base constructor DigitalSignal () is automatically called when
     // no other base constructor is called.
     delta=0;
     begin_time=0;
 }
 
-EvenSampledSignal::EvenSampledSignal (const std::string &infile) {
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const std::string &infile) {
     std::ifstream fpin(infile);
     fpin >> *this;
     if (!fpin.eof()) {                            // failed to read from even sampled 2-column file.
@@ -165,9 +208,9 @@ EvenSampledSignal::EvenSampledSignal (const std::string &infile) {
         std::cerr << "Warning: when constructing EvenSampledSignal, the input file: " << infile
                   << " shows sign of un-even sampling. Using interpolation ..."<< std::endl;
 
-        DigitalSignal item=DigitalSignal(infile);
+        BasicDigitalSignal<T> item=BasicDigitalSignal<T>(infile);
         double dt=item.SignalDuration()/(item.Size()-1);
-        *this=EvenSampledSignal(item,dt);
+        *this=BasicEvenSampledSignal<T>(item,dt);
     }
     else {
         filename=infile;
@@ -176,11 +219,13 @@ EvenSampledSignal::EvenSampledSignal (const std::string &infile) {
 }
 
 
-EvenSampledSignal::EvenSampledSignal (const std::string &infile,
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const std::string &infile,
                                       const double &dt, const double &bt) {
     std::ifstream fpin(infile);
     double y;
-    while (fpin >> y) amp.push_back(y);
+    auto &x=amp.Mutable();
+    while (fpin >> y) x.push_back(y);
     fpin.close();
 
     delta=dt;
@@ -189,11 +234,12 @@ EvenSampledSignal::EvenSampledSignal (const std::string &infile,
 }
 
 
-EvenSampledSignal::EvenSampledSignal (const DigitalSignal &item, const double &dt) {
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const BasicDigitalSignal<T> &item, const double &dt) {
 
     // Interpolation.
     auto xx=::CreateGrid(item.BeginTime(),item.EndTime(),dt,1);
-    amp=::Interpolate(item.GetTime(),item.GetAmp(),xx);
+    AssignAmp(::Interpolate(item.GetTime(),item.GetAmp(),xx));
 
     delta=dt;
     begin_time=item.BeginTime();
@@ -203,14 +249,15 @@ EvenSampledSignal::EvenSampledSignal (const DigitalSignal &item, const double &d
     if (item.GetPeak()!=(std::size_t)-1) FindPeakAround(item.PeakTime(),10*GetDelta());
 }
 
-EvenSampledSignal::EvenSampledSignal (const EvenSampledSignal &item, const double &dt) {
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const BasicEvenSampledSignal<T> &item, const double &dt) {
 
     // If sampling rate is not the same, interpolate to dt.
     if (item.GetDelta()<=dt*0.99 || dt*1.01<=item.GetDelta()){
         auto xx=::CreateGrid(item.BeginTime(),item.EndTime(),dt,1);
-        amp=::Interpolate(item.GetTime(),item.GetAmp(),xx);
+        AssignAmp(::Interpolate(item.GetTime(),item.GetAmp(),xx));
     }
-    else amp=item.GetAmp();
+    else amp=item.amp;          // shared, see CowVector.hpp.
 
     delta=dt;
     begin_time=item.BeginTime();
@@ -221,10 +268,31 @@ EvenSampledSignal::EvenSampledSignal (const EvenSampledSignal &item, const doubl
 }
 
 template<typename T>
-EvenSampledSignal::EvenSampledSignal (const std::vector<T> &item, const double &dt,
+template<typename U>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const BasicEvenSampledSignal<U> &item) {
+    AssignAmp(item.GetAmp());
+    peak=item.GetPeak();
+    filename=item.GetFileName();
+    amp_multiplier=item.GetAmpMultiplier();
+    this->SetTag(item.GetTag());
+    delta=item.GetDelta();
+    begin_time=item.BeginTime();
+}
+
+template<typename T>
+template<typename U>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (const std::vector<U> &item, const double &dt,
                                       const double &bt, const std::string &infile) {
-    amp.resize(item.size());
-    for (std::size_t i=0;i<Size();++i) amp[i]=item[i];
+    AssignAmp(item);
+    delta=dt;
+    begin_time=bt;
+    filename=infile;
+}
+
+template<typename T>
+BasicEvenSampledSignal<T>::BasicEvenSampledSignal (std::vector<T> &&item, const double &dt,
+                                      const double &bt, const std::string &infile) {
+    amp=std::move(item);
     delta=dt;
     begin_time=bt;
     filename=infile;
@@ -232,15 +300,16 @@ EvenSampledSignal::EvenSampledSignal (const std::vector<T> &item, const double &
 
 // Member function definitions.
 
-bool EvenSampledSignal::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS){
+template<typename T>
+bool BasicEvenSampledSignal<T>::CheckAndCutToNPTS(const double &t1, const std::size_t &NPTS){
 
     if (t1<BeginTime()) return false;
     std::size_t d1=LocateTime(t1);
     if (d1+NPTS>Size()) return false;
 
     // Cut.
-    std::vector<double> NewAmp(GetAmp().begin()+d1,GetAmp().begin()+d1+NPTS);
-    std::swap(NewAmp,amp);
+    std::vector<T> NewAmp(GetAmp().begin()+d1,GetAmp().begin()+d1+NPTS);
+    amp=std::move(NewAmp);
 
     if (d1<=GetPeak() && GetPeak()<d1+NPTS) peak-=d1;
     else peak=-1;
@@ -251,7 +320,8 @@ bool EvenSampledSignal::CheckAndCutToNPTS(const double &t1, const std::size_t &N
 }
 
 // Cut the data within a window. If cut failed, don't cut and return false.
-bool EvenSampledSignal::CheckAndCutToWindow(const double &t1, const double &t2){
+template<typename T>
+bool BasicEvenSampledSignal<T>::CheckAndCutToWindow(const double &t1, const double &t2){
 
     if (!CheckWindow(t1,t2)) return false;
 
@@ -259,8 +329,8 @@ bool EvenSampledSignal::CheckAndCutToWindow(const double &t1, const double &t2){
     std::size_t d1=LocateTime(t1),d2=LocateTime(t2);
     ++d2;
 
-    std::vector<double> NewAmp(GetAmp().begin()+d1,GetAmp().begin()+d2);
-    std::swap(NewAmp,amp);
+    std::vector<T> NewAmp(GetAmp().begin()+d1,GetAmp().begin()+d2);
+    amp=std::move(NewAmp);
 
     if (d1<=GetPeak() && GetPeak()<d2) peak-=d1;
     else peak=-1;
@@ -272,7 +342,8 @@ bool EvenSampledSignal::CheckAndCutToWindow(const double &t1, const double &t2){
 
 
 // Find the position of max|amp| around given time.
-void EvenSampledSignal::FindPeakAround(const double &t, const double &w, const bool &positiveOnly){
+template<typename T>
+void BasicEvenSampledSignal<T>::FindPeakAround(const double &t, const double &w, const bool &positiveOnly){
     std::size_t d1=LocateTime(t-w),d2=LocateTime(t+w);
     ++d2;
 
@@ -298,7 +369,8 @@ void EvenSampledSignal::FindPeakAround(const double &t, const double &w, const b
     }
 }
 
-std::vector<double> EvenSampledSignal::GetTime() const {
+template<typename T>
+std::vector<double> BasicEvenSampledSignal<T>::GetTime() const {
     std::vector<double> ans;
     if (Size()!=0)
         for (std::size_t i=0;i<Size();++i)
@@ -308,16 +380,19 @@ std::vector<double> EvenSampledSignal::GetTime() const {
 
 
 // cos (-pi,pi) shaped taper at two ends.
-void EvenSampledSignal::HannTaper(const double &wl){
+template<typename T>
+void BasicEvenSampledSignal<T>::HannTaper(const double &wl){
     if (wl*2>SignalDuration()) throw std::runtime_error("Hanning window too wide.");
+    auto &x=amp.Mutable();
     for (std::size_t i=0;i<Size();++i){
         double len=std::min(i,Size()-1-i)*GetDelta();
-        if (len<wl) amp[i]*=0.5-0.5*cos(len/wl*M_PI);
+        if (len<wl) x[i]*=0.5-0.5*cos(len/wl*M_PI);
     }
 }
 
 // Return a std::size_t between [0,Size()-1]
-std::size_t EvenSampledSignal::LocateTime(const double &t) const{
+template<typename T>
+std::size_t BasicEvenSampledSignal<T>::LocateTime(const double &t) const{
     if (t<BeginTime()) return 0;
     if (t>EndTime()) return Size()-1;
     std::size_t ans=(t-BeginTime())/GetDelta();
@@ -327,18 +402,21 @@ std::size_t EvenSampledSignal::LocateTime(const double &t) const{
 }
 
 // Print some info.
-void EvenSampledSignal::PrintInfo() const {
-    DigitalSignal::PrintInfo();
+template<typename T>
+void BasicEvenSampledSignal<T>::PrintInfo() const {
+    BasicDigitalSignal<T>::PrintInfo();
     std::cout << "Sampling rate: " << GetDelta() << '\n';
 }
 
 // remove drift and DC.
-std::pair<double,double> EvenSampledSignal::RemoveTrend(){
-    return ::RemoveTrend(amp,GetDelta(),BeginTime());
+template<typename T>
+std::pair<double,double> BasicEvenSampledSignal<T>::RemoveTrend(){
+    return ::RemoveTrend(amp.Mutable(),GetDelta(),BeginTime());
 }
 
 // area under the curve, with different modes according to different operators.
-double EvenSampledSignal::SumArea(const double &t1, const double &t2, const size_t &mode) const {
+template<typename T>
+double BasicEvenSampledSignal<T>::SumArea(const double &t1, const double &t2, const size_t &mode) const {
     if (t1>t2) throw std::runtime_error("In SumArea, t2<t1 ...");
     std::size_t p1=LocateTime(t1),p2=LocateTime(t2);
     if (p1==p2) return 0;
@@ -364,12 +442,14 @@ double EvenSampledSignal::SumArea(const double &t1, const double &t2, const size
 }
 
 // taper window half-length is wl, zero half-length is zl.
-void EvenSampledSignal::ZeroOutHannTaper(const double &wl, const double &zl){
+template<typename T>
+void BasicEvenSampledSignal<T>::ZeroOutHannTaper(const double &wl, const double &zl){
     if ((wl+zl)*2>SignalDuration()) throw std::runtime_error("ZeroOutHanning window too wide.");
+    auto &x=amp.Mutable();
     for (std::size_t i=0;i<Size();++i){
         double len=std::min(i,Size()-1-i)*GetDelta();
-        if (len<zl) amp[i]=0;
-        else if (len<zl+wl) amp[i]*=0.5-0.5*cos((len-zl)/wl*M_PI);
+        if (len<zl) x[i]=0;
+        else if (len<zl+wl) x[i]*=0.5-0.5*cos((len-zl)/wl*M_PI);
     }
 }
 
@@ -379,7 +459,8 @@ void EvenSampledSignal::ZeroOutHannTaper(const double &wl, const double &zl){
 
 // Take absolute amplitude then do the integral.
 // Calculate the energy.
-double EvenSampledSignal::AbsIntegral() const {
+template<typename T>
+double BasicEvenSampledSignal<T>::AbsIntegral() const {
     auto f=[](const double &s){return (s>0?s:-s);};
     return ::SimpsonRule(GetAmp().begin(),GetAmp().end(),GetDelta(),f);
 }
@@ -388,11 +469,13 @@ double EvenSampledSignal::AbsIntegral() const {
 // Will only alter the overlapping part.
 // Sampling rate should be the same.
 // Difference from operator+ : not as strict as operator +, signal length/begin time can be different.
-void EvenSampledSignal::AddSignal(const EvenSampledSignal &s2, const double &dt) {
+template<typename T>
+void BasicEvenSampledSignal<T>::AddSignal(const BasicEvenSampledSignal<T> &s2, const double &dt) {
     AddStripSignal(s2,dt,true);
 }
 
-void EvenSampledSignal::AddStripSignal(const EvenSampledSignal &s2, const double &dt, const bool &flag){
+template<typename T>
+void BasicEvenSampledSignal<T>::AddStripSignal(const BasicEvenSampledSignal<T> &s2, const double &dt, const bool &flag){
     
     if (fabs(GetDelta()-s2.GetDelta())>1e-5)
         throw std::runtime_error("Tried to "+std::string(flag?"add":"strip")+" signal with different sampling rate.");
@@ -405,23 +488,40 @@ void EvenSampledSignal::AddStripSignal(const EvenSampledSignal &s2, const double
     std::size_t S1Begin=LocateTime(t1);
 
     int mul=(flag?1:-1);
-    for (std::size_t i=S1Begin;i<=LocateTime(t2);++i) {
+    std::size_t S1End=LocateTime(t2);
+    const std::vector<T> &y=s2.GetAmp();
+    auto &x=amp.Mutable();
+    for (std::size_t i=S1Begin;i<=S1End;++i) {
         size_t index=S2Begin+i-S1Begin;
-        if (0<=index && index<s2.Size())
-            amp[i]+=s2.amp[index]*mul;
+        if (0<=index && index<y.size())
+            x[i]+=y[index]*mul;
     }
     return;
 }
 
 // butterworth filter.
-void EvenSampledSignal::Butterworth(const double &f1, const double &f2,
+template<typename T>
+void BasicEvenSampledSignal<T>::Butterworth(const double &f1, const double &f2,
                                     const int &order, const int &passes){
-    ::Butterworth(amp,GetDelta(),f1,f2,order,passes);
+    ::Butterworth(amp.Mutable(),GetDelta(),f1,f2,order,passes);
+}
+
+// butterworth filter on many signals (signals with the same delta and size
+// are filtered together).
+template<typename T>
+void BasicEvenSampledSignal<T>::Butterworth(const std::vector<BasicEvenSampledSignal *> &S, const double &f1,
+                                    const double &f2, const int &order, const int &passes){
+    std::map<double,std::vector<std::vector<T>*>> groups;
+    for (const auto &item: S)
+        if (item!=nullptr) groups[item->GetDelta()].push_back(&(item->amp.Mutable()));
+    for (const auto &item: groups)
+        ::ButterworthBatch(item.second,item.first,f1,f2,order,passes);
 }
 
 // Compare two signals around their peaks.
 // t1 t2 are time window relative to their own peaks (in seconds, default: t1=-5, t2=5)
-SignalCompareResults EvenSampledSignal::CompareSignal(const EvenSampledSignal &S2,
+template<typename T>
+SignalCompareResults BasicEvenSampledSignal<T>::CompareSignal(const BasicEvenSampledSignal<T> &S2,
                                                       const double &t1, const double &t2, const double &AmpLevel) const{
     if (fabs(GetDelta()-S2.GetDelta())>0.01*GetDelta())
         throw std::runtime_error("Comparing two differently sampled signals.");
@@ -429,7 +529,7 @@ SignalCompareResults EvenSampledSignal::CompareSignal(const EvenSampledSignal &S
     if (GetPeak()==(std::size_t)-1 || S2.GetPeak()==(std::size_t)-1)
         throw std::runtime_error("Comparing two signals, but their peaks are not defined.");
 
-    EvenSampledSignal s1=*this, s2=S2;
+    BasicEvenSampledSignal<T> s1=*this, s2=S2;
     s1/=fabs(GetAmp()[GetPeak()]);
     s2/=fabs(S2.GetAmp()[S2.GetPeak()]);
 
@@ -440,9 +540,13 @@ SignalCompareResults EvenSampledSignal::CompareSignal(const EvenSampledSignal &S
 
 // Cross correlate current signal with input signal within their own window.
 // Notice we are returning the time shift (in second)
-std::pair<double,double> EvenSampledSignal::CrossCorrelation(const double &t1, const double &t2,
-                                                             const EvenSampledSignal &S2, const double &h1, const double &h2,
-                                                             const int &Flip, const std::pair<int,int> &ShiftLimit) const {
+// SubSample: refine the shift and ccc with a parabola through the best lag and its neighbours.
+template<typename T>
+template<typename U>
+std::pair<double,double> BasicEvenSampledSignal<T>::CrossCorrelation(const double &t1, const double &t2,
+                                                             const BasicEvenSampledSignal<U> &S2, const double &h1, const double &h2,
+                                                             const int &Flip, const std::pair<int,int> &ShiftLimit,
+                                                             const bool &SubSample) const {
     // Check window position.
     if (!CheckWindow(t1,t2)) {
         std::cerr << "CrossCorrelation window on signal 1 is not proper." << std::endl;
@@ -456,42 +560,64 @@ std::pair<double,double> EvenSampledSignal::CrossCorrelation(const double &t1, c
         return {};
     }
 
+    CrossCorrelationEngine E(S2.GetAmp().begin()+S2.LocateTime(h1),
+                             S2.GetAmp().begin()+S2.LocateTime(h2)+1,Flip,ShiftLimit);
+    return CrossCorrelation(t1,t2,E,SubSample);
+}
 
-    auto res=::CrossCorrelation(GetAmp().begin()+LocateTime(t1),
-                              GetAmp().begin()+LocateTime(t2)+1,
-                              S2.GetAmp().begin()+S2.LocateTime(h1),
-                              S2.GetAmp().begin()+S2.LocateTime(h2)+1,false,Flip,ShiftLimit);
-    return std::make_pair(res.first.first*GetDelta(),res.first.second);
+// Same as above, with the other signal (window, Flip and ShiftLimit) prepared in E.
+// Use it to cross correlate many signals with the same one.
+template<typename T>
+std::pair<double,double> BasicEvenSampledSignal<T>::CrossCorrelation(const double &t1, const double &t2,
+                                                             const CrossCorrelationEngine &E,
+                                                             const bool &SubSample) const {
+    if (!CheckWindow(t1,t2)) {
+        std::cerr << "CrossCorrelation window on signal 1 is not proper." << std::endl;
+        return {};
+    }
+
+    int m=LocateTime(t2)+1-LocateTime(t1);
+    auto res=E(GetAmp().begin()+LocateTime(t1),GetAmp().begin()+LocateTime(t2)+1,SubSample);
+    if (!SubSample || res.second.empty())
+        return std::make_pair(res.first.first*GetDelta(),res.first.second);
+
+    // res.second starts at the left most shift.
+    int ShiftLeft=E.Shifts(m).first;
+    auto p=ParabolicPeak(res.second,res.first.first-ShiftLeft);
+    return std::make_pair((p.first+ShiftLeft)*GetDelta(),p.second);
 }
 
 
 // Convolve with another signal s2, truncated to keep s1's size.
 // The place to truncated depends on S2'peak position.
 // This is acausal convolution: I was trying to keep the original peak's position.
-void EvenSampledSignal::Convolve(const EvenSampledSignal &s2){
+template<typename T>
+void BasicEvenSampledSignal<T>::Convolve(const BasicEvenSampledSignal<T> &s2){
     std::size_t OrignalSize=Size();
-    amp=::Convolve(GetAmp(),s2.GetAmp());
-    std::rotate(amp.begin(),amp.begin()+s2.GetPeak(),amp.end());
-    amp.resize(OrignalSize);
+    AssignAmp(::Convolve(GetAmp(),s2.GetAmp()));
+    auto &x=amp.Mutable();
+    std::rotate(x.begin(),x.begin()+s2.GetPeak(),x.end());
+    x.resize(OrignalSize);
 }
 
 // Differentiation (from displacement to velocity).
 // Notice this will decrease the length of the signal by 1.
-void EvenSampledSignal::Diff(){
+template<typename T>
+void BasicEvenSampledSignal<T>::Diff(){
     if (Size()<=1) return;
-    auto NewAmp=::Diff(amp);
-    std::swap(amp,NewAmp);
+    AssignAmp(::Diff(GetAmp()));
     *this/=GetDelta();
 }
 
-std::pair<EvenSampledSignal,EvenSampledSignal>
-EvenSampledSignal::FFT(const bool &ReturnAmpAndPhase) const {
+template<typename T>
+std::pair<BasicEvenSampledSignal<T>,BasicEvenSampledSignal<T>>
+BasicEvenSampledSignal<T>::FFT(const bool &ReturnAmpAndPhase) const {
 
     if (Size()==1) return {};
 
     auto res=::FFT(GetAmp(),GetDelta(),ReturnAmpAndPhase);
-    return {EvenSampledSignal(res.first,1.0/2/GetDelta()/(res.first.size()-1),0),
-            EvenSampledSignal(res.second,1.0/2/GetDelta()/(res.second.size()-1),0)};
+    return {BasicEvenSampledSignal<T>(res.first,1.0/2/GetDelta()/(res.first.size()-1),0),
+            BasicEvenSampledSignal<T>(res.second,1.0/2/GetDelta()/(res.second.size()-1),0)};
 }
 
 
@@ -502,7 +628,8 @@ EvenSampledSignal::FFT(const bool &ReturnAmpAndPhase) const {
 // (as a result the given time becomes the begin time.)
 // Will maintain the maximum valid length.
 // Will do a time shift such that the FRS traces starts at t=0.
-void EvenSampledSignal::FlipReverseSum(const double &t) {
+template<typename T>
+void BasicEvenSampledSignal<T>::FlipReverseSum(const double &t) {
     if (t<BeginTime() || t>EndTime()) {
         std::cerr << "In FRS, the given time is invalid." << std::endl;
         return;
@@ -512,30 +639,35 @@ void EvenSampledSignal::FlipReverseSum(const double &t) {
     for (std::size_t i=0;i<new_npts;++i)
         new_amp[i]=GetAmp()[l+i]-GetAmp()[l-i];
 
-    EvenSampledSignal new_signal(new_amp,GetDelta());
+    BasicEvenSampledSignal<T> new_signal(new_amp,GetDelta());
     std::swap(*this,new_signal);
     return;
 }
 
 // gaussian blur.
 // changes: amp(value change).
-void EvenSampledSignal::GaussianBlur(const double &sigma){
-    ::GaussianBlur(amp,GetDelta(),sigma);
+template<typename T>
+void BasicEvenSampledSignal<T>::GaussianBlur(const double &sigma, const bool &Recursive){
+    ::GaussianBlur(amp.Mutable(),GetDelta(),sigma,false,Recursive);
 }
 
 // Integrate (from velocity to displacement).
-void EvenSampledSignal::Integrate(){
-    std::partial_sum(amp.begin(),amp.end(),amp.begin());
+template<typename T>
+void BasicEvenSampledSignal<T>::Integrate(){
+    auto &x=amp.Mutable();
+    std::partial_sum(x.begin(),x.end(),x.begin());
     *this*=GetDelta();
 }
 
 // Interpolate to certain sampling rate.
-void EvenSampledSignal::Interpolate(const double &dt){
-    *this=EvenSampledSignal (*this,dt);
+template<typename T>
+void BasicEvenSampledSignal<T>::Interpolate(const double &dt){
+    *this=BasicEvenSampledSignal<T> (*this,dt);
 }
 
 // Measure SNR.
-double EvenSampledSignal::SNR(const double &nt1, const double &nt2,
+template<typename T>
+double BasicEvenSampledSignal<T>::SNR(const double &nt1, const double &nt2,
                               const double &st1, const double &st2) const{
     if (!CheckWindow(nt1,nt2) || !CheckWindow(st1,st2))
         throw std::runtime_error("SNR measuring error: window not suitable.");
@@ -544,22 +676,36 @@ double EvenSampledSignal::SNR(const double &nt1, const double &nt2,
     return ::SNR(GetAmp(),n1,n2-n1,s1,s2-s1);
 }
 
+// Measure SNR with several windows (one Hilbert transform).
+template<typename T>
+std::vector<double> BasicEvenSampledSignal<T>::SNR(const std::vector<std::array<double,4>> &windows) const{
+    std::vector<std::array<int,4>> W;
+    for (const auto &w: windows) {
+        if (!CheckWindow(w[0],w[1]) || !CheckWindow(w[2],w[3]))
+            throw std::runtime_error("SNR measuring error: window not suitable.");
+        int n1=LocateTime(w[0]),n2=LocateTime(w[1]),s1=LocateTime(w[2]),s2=LocateTime(w[3]);
+        W.push_back({{n1,n2-n1,s1,s2-s1}});
+    }
+    return ::SNR(GetAmp(),W);
+}
+
 // Stretch the signal horizontally and vertically.
 // Keep sampling rate the same, keep peak time the same, which means updates:
 // begin_time, peak,
-EvenSampledSignal EvenSampledSignal::Stretch(const double &h) const{
+template<typename T>
+BasicEvenSampledSignal<T> BasicEvenSampledSignal<T>::Stretch(const double &h) const{
 
     if (GetPeak()>=Size())
         throw std::runtime_error("In stretching, peak not defined.");
 
-    EvenSampledSignal ans;
+    BasicEvenSampledSignal<T> ans;
     if (h==1) {
         ans=*this;
         return ans;
     }
 
     // Stretch the signal.
-    ans.amp=::StretchSignal(GetAmp(),h);
+    ans.AssignAmp(::StretchSignal(GetAmp(),h));
 
     // Set times.
     double OldPeakTime=PeakTime(),OldBeginTime=BeginTime();
@@ -576,7 +722,8 @@ EvenSampledSignal EvenSampledSignal::Stretch(const double &h) const{
 // Need peaks already defined on *this and s.
 // method=0: compare use Amp_WinDiff.
 // method=1: compare use Amp_Diff.
-EvenSampledSignal EvenSampledSignal::StretchToFit(const EvenSampledSignal &s, const double &t1, const double &t2,
+template<typename T>
+BasicEvenSampledSignal<T> BasicEvenSampledSignal<T>::StretchToFit(const BasicEvenSampledSignal<T> &s, const double &t1, const double &t2,
                                                   const double &h1, const double &h2, const double &ampLevel,
                                                   const bool &adaptive, const std::size_t method) const {
 
@@ -612,7 +759,8 @@ EvenSampledSignal EvenSampledSignal::StretchToFit(const EvenSampledSignal &s, co
     return Stretch(H+1);
 }
 
-EvenSampledSignal EvenSampledSignal::StretchToFitHalfWidth(const EvenSampledSignal &s) const {
+template<typename T>
+BasicEvenSampledSignal<T> BasicEvenSampledSignal<T>::StretchToFitHalfWidth(const BasicEvenSampledSignal<T> &s) const {
     auto anchor1=this->FindAmplevel(0.5);
     auto anchor2=s.FindAmplevel(0.5);
 
@@ -624,20 +772,22 @@ EvenSampledSignal EvenSampledSignal::StretchToFitHalfWidth(const EvenSampledSign
 // Will only alter the overlapping part.
 // Sampling rate should be the same.
 // Difference from operator- : not as strict as operator -, signal length/begin time can be different.
-void EvenSampledSignal::StripSignal(const EvenSampledSignal &s2, const double &dt) {
+template<typename T>
+void BasicEvenSampledSignal<T>::StripSignal(const BasicEvenSampledSignal<T> &s2, const double &dt) {
     AddStripSignal(s2,dt,false);
 }
 
 // Make a t* operator-convolved waveform.
 // Keep sampling rate the same, keep data length the same.
 // Notice: peak amplitude and position could be changed.
-EvenSampledSignal EvenSampledSignal::Tstar(const double &ts, const double &tol) const{
-    EvenSampledSignal ans(*this);
+template<typename T>
+BasicEvenSampledSignal<T> BasicEvenSampledSignal<T>::Tstar(const double &ts, const double &tol) const{
+    BasicEvenSampledSignal<T> ans(*this);
     if (ts<=0) return ans;
 
     // Create a t* operator.
     auto res=::TstarOperator(ts,GetDelta(),tol);
-    EvenSampledSignal Ts(res.first,GetDelta(),-GetDelta()*res.second);         // Ts has peak at ~0.
+    BasicEvenSampledSignal<T> Ts(res.first,GetDelta(),-GetDelta()*res.second);         // Ts has peak at ~0.
     Ts.FindPeakAround(0,1);                                                       // Find Ts's peak.
     ans.Convolve(Ts);
     return ans;
@@ -646,20 +796,23 @@ EvenSampledSignal EvenSampledSignal::Tstar(const double &ts, const double &tol)
 // Notice: no pre-processing (such as remove trend or taper).
 // Changes:
 // amp(signal length change),peak(=Size()/2),begin_time(relative to peak time)
-void EvenSampledSignal::WaterLevelDecon(const EvenSampledSignal &source, const double &wl) {
+template<typename T>
+void BasicEvenSampledSignal<T>::WaterLevelDecon(const BasicEvenSampledSignal<T> &source, const double &wl) {
     if (fabs(GetDelta()-source.GetDelta())>1e-5)
         throw std::runtime_error("Signal inputs of decon have different sampling rate.");
 
-    amp=::WaterLevelDecon(GetAmp(),GetPeak(),source.GetAmp(),source.GetPeak(),GetDelta(),wl);
+    AssignAmp(::WaterLevelDecon(GetAmp(),GetPeak(),source.GetAmp(),source.GetPeak(),GetDelta(),wl));
     peak=Size()/2;
     begin_time=-GetDelta()*(GetPeak()-1);
 }
 
 // Stack two same sampling rate, same begin time signal.
-EvenSampledSignal &EvenSampledSignal::operator+=(const EvenSampledSignal &item){
+template<typename T>
+template<typename U>
+BasicEvenSampledSignal<T> &BasicEvenSampledSignal<T>::operator+=(const BasicEvenSampledSignal<U> &item){
 
     if (Size()==0) {
-        *this=item;
+        *this=BasicEvenSampledSignal<T>(item);
         delta=item.GetDelta();
         filename="--StackResult";
         amp_multiplier=1;
@@ -682,16 +835,19 @@ EvenSampledSignal &EvenSampledSignal::operator+=(const EvenSampledSignal &item){
                                  "number of points: "+std::to_string(Size())+" v.s. "
                                 +std::to_string(item.Size()));
 
-    for (std::size_t i=0;i<Size();++i) amp[i]+=item.GetAmp()[i];
+    auto &x=amp.Mutable();
+    for (std::size_t i=0;i<Size();++i) x[i]+=item.GetAmp()[i];
 
     return *this;
 }
 
 // Subtract two same sampling rate, same begin time signal.
-EvenSampledSignal &EvenSampledSignal::operator-=(const EvenSampledSignal &item){
+template<typename T>
+template<typename U>
+BasicEvenSampledSignal<T> &BasicEvenSampledSignal<T>::operator-=(const BasicEvenSampledSignal<U> &item){
 
     if (Size()==0) {
-        *this=item;
+        *this=BasicEvenSampledSignal<T>(item);
         delta=item.GetDelta();
         filename="--SubtractResult";
         amp_multiplier=1;
@@ -715,7 +871,8 @@ EvenSampledSignal &EvenSampledSignal::operator-=(const EvenSampledSignal &item){
                                  "number of points: "+std::to_string(Size())+" v.s. "
                                 +std::to_string(item.Size()));
 
-    for (std::size_t i=0;i<Size();++i) amp[i]-=item.GetAmp()[i];
+    auto &x=amp.Mutable();
+    for (std::size_t i=0;i<Size();++i) x[i]-=item.GetAmp()[i];
 
     return *this;
 }
@@ -727,10 +884,12 @@ End of member function/operator definitions. -----------------------------------
 
 // Put operator define before other non-member function to avoid confusion.
 // Overload operator ">>" to read a signal from a two-columned input (stdin/file/etc.)
-std::istream &operator>>(std::istream &is, EvenSampledSignal &item){
+template<typename T>
+std::istream &operator>>(std::istream &is, BasicEvenSampledSignal<T> &item){
 
     item.Clear();
     double x,y,dt=-1,CurEndTime=0;
+    auto &amp=item.amp.Mutable();
     while (is >> x >> y) {
         if (item.Size()==0)
             item.begin_time=x;
@@ -753,7 +912,7 @@ std::istream &operator>>(std::istream &is, EvenSampledSignal &item){
                 dt=(x-item.begin_time)/item.Size();
         }
         CurEndTime=x;
-        item.amp.push_back(y);
+        amp.push_back(y);
     }
 
     item.delta=(CurEndTime-item.begin_time);
@@ -767,7 +926,8 @@ std::istream &operator>>(std::istream &is, EvenSampledSignal &item){
 
 // Overload operator "<<" to print a signal in a two-columned format.
 // Customize this section code to define other printing format.
-std::ostream &operator<<(std::ostream &os, const EvenSampledSignal &item){
+template<typename T>
+std::ostream &operator<<(std::ostream &os, const BasicEvenSampledSignal<T> &item){
 
     /*
 
@@ -794,47 +954,56 @@ std::ostream &operator<<(std::ostream &os, const EvenSampledSignal &item){
 }
 
 // Overload operator "+,-" to ShiftDC.
-EvenSampledSignal operator+(const EvenSampledSignal &item,const double &a){
-    EvenSampledSignal ans(item);
+template<typename T>
+BasicEvenSampledSignal<T> operator+(const BasicEvenSampledSignal<T> &item,const double &a){
+    BasicEvenSampledSignal<T> ans(item);
     ans+=a;
     return ans;
 }
-EvenSampledSignal operator+(const double &a,const EvenSampledSignal &item){
+template<typename T>
+BasicEvenSampledSignal<T> operator+(const double &a,const BasicEvenSampledSignal<T> &item){
     return item+a;
 }
-EvenSampledSignal operator+(const EvenSampledSignal &s1,const EvenSampledSignal &s2){
-    EvenSampledSignal ans(s1);
+template<typename T>
+BasicEvenSampledSignal<T> operator+(const BasicEvenSampledSignal<T> &s1,const BasicEvenSampledSignal<T> &s2){
+    BasicEvenSampledSignal<T> ans(s1);
     ans+=s2;
     return ans;
 }
-EvenSampledSignal operator-(const EvenSampledSignal &item,const double &a){
+template<typename T>
+BasicEvenSampledSignal<T> operator-(const BasicEvenSampledSignal<T> &item,const double &a){
     return item+(-a);
 }
-EvenSampledSignal operator-(const EvenSampledSignal &s1,const EvenSampledSignal &s2){
-    EvenSampledSignal ans(s1);
+template<typename T>
+BasicEvenSampledSignal<T> operator-(const BasicEvenSampledSignal<T> &s1,const BasicEvenSampledSignal<T> &s2){
+    BasicEvenSampledSignal<T> ans(s1);
     ans-=s2;
     return ans;
 }
 
 // Overload operator "*,/" to Scale.
-EvenSampledSignal operator*(const EvenSampledSignal &item,const double &a){
-    EvenSampledSignal ans(item);
+template<typename T>
+BasicEvenSampledSignal<T> operator*(const BasicEvenSampledSignal<T> &item,const double &a){
+    BasicEvenSampledSignal<T> ans(item);
     ans*=a;
     return ans;
 }
-EvenSampledSignal operator*(const double &a,const EvenSampledSignal &item){
+template<typename T>
+BasicEvenSampledSignal<T> operator*(const double &a,const BasicEvenSampledSignal<T> &item){
     return item*a;
 }
-EvenSampledSignal operator/(const EvenSampledSignal &item,const double &a){
-    EvenSampledSignal ans(item);
+template<typename T>
+BasicEvenSampledSignal<T> operator/(const BasicEvenSampledSignal<T> &item,const double &a){
+    BasicEvenSampledSignal<T> ans(item);
     ans/=a;
     return ans;
 }
 
 // Other non-member functions.
 
-std::pair<EvenSampledSignal,EvenSampledSignal>
-StackSignals(const std::vector<EvenSampledSignal> &Signals,
+template<typename T>
+std::pair<BasicEvenSampledSignal<T>,BasicEvenSampledSignal<T>>
+StackSignals(const std::vector<BasicEvenSampledSignal<T>> &Signals,
              const std::vector<double> &Weights=std::vector<double> ()) {
 
     // Check size.
@@ -865,18 +1034,20 @@ StackSignals(const std::vector<EvenSampledSignal> &Signals,
         S[i]=res.first;
         STD[i]=res.second;
     }
-    return {EvenSampledSignal(S,dt,bt),EvenSampledSignal(STD,dt,bt)};
+    return {BasicEvenSampledSignal<T>(S,dt,bt),BasicEvenSampledSignal<T>(STD,dt,bt)};
 }
 
-EvenSampledSignal IFFT(const EvenSampledSignal &amp,const EvenSampledSignal &phase) {
+template<typename T>
+BasicEvenSampledSignal<T> IFFT(const BasicEvenSampledSignal<T> &amp,const BasicEvenSampledSignal<T> &phase) {
     auto res=::IFFT(amp.GetAmp(),phase.GetAmp(),amp.GetDelta());
-    return EvenSampledSignal(res,1.0/2/amp.GetTime().back());
+    return BasicEvenSampledSignal<T>(res,1.0/2/amp.GetTime().back());
 }
 
 // I guess "this" pointer will have dynamic binding?
 // Therefore you need to define another function for EvenSampledSignal to call
 // its version of "<<" operator.
-void EvenSampledSignal::OutputToFile(const std::string &s) const {
+template<typename T>
+void BasicEvenSampledSignal<T>::OutputToFile(const std::string &s) const {
     std::ofstream fpout(s);
     fpout << (*this) << std::endl;
     fpout.close();
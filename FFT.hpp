@@ -9,6 +9,8 @@ extern "C"{
 #include<fftw3.h>
 }
 
+#include<FFTWPlanCache.hpp>
+
 /*********************************************************************
  * This C++ template runs fft on input real signal and return the
  * amplitudes and phases / or real part and imaginary part.
@@ -43,11 +45,8 @@ FFT(const std::vector<T> &x, const double &delta, const bool &ReturnAmpAndPhase=
 
     int n=x.size(),N=n+(n%2);
 
-    double *In = new double [N];
-    fftw_complex *Out=(fftw_complex *)fftw_malloc((N/2+1)*sizeof(fftw_complex));;
-
-    // Define fft transform plan.
-    fftw_plan p=fftw_plan_dft_r2c_1d(N,In,Out,FFTW_ESTIMATE);
+    double *In=FFTWPlanCache::Real(N);
+    fftw_complex *Out=FFTWPlanCache::Complex(N/2+1);
 
     // Push data into the plan.
     // Pad the signal with one zero if the length of original signal is odd.
@@ -55,7 +54,7 @@ FFT(const std::vector<T> &x, const double &delta, const bool &ReturnAmpAndPhase=
     if (n%2==1) In[N-1]=0;
 
     // Run fft.
-    fftw_execute(p);
+    fftw_execute_dft_r2c(FFTWPlanCache::R2C(N),In,Out);
 
     std::vector<double> X,Y;
     if (ReturnAmpAndPhase) {
@@ -73,11 +72,6 @@ FFT(const std::vector<T> &x, const double &delta, const bool &ReturnAmpAndPhase=
         }
     }
 
-    // free resources.
-    fftw_destroy_plan(p);
-    fftw_free(Out);
-    delete [] In;
-
     return {X,Y};
 }
 
@@ -0,0 +1,204 @@
+#ifndef ASU_FFTWPLANCACHE
+#define ASU_FFTWPLANCACHE
+// Need sci-libs/fftw
+
+#include<map>
+#include<string>
+#include<cstdio>
+#include<cstdlib>
+#include<tuple>
+#include<mutex>
+#include<iostream>
+#include<stdexcept>
+#include<unistd.h>
+
+extern "C"{
+#include<fftw3.h>
+}
+
+#include<FFTWPlannerMutex.hpp>
+
+/*********************************************************************
+ * This C++ class is a process-wide cache of 1D real fftw plans, plus
+ * per-thread scratch buffers to run them on.
+ *
+ * Plans are keyed by length, direction and planner flags. The first
+ * request of a key makes the plan (under FFTWPlannerMutex, so FFTW_MEASURE
+ * is only paid once per key); later requests, from any thread, reuse it.
+ * Plans live until the end of the program.
+ *
+ * Optionally, the planner's wisdom can persist across processes: after
+ * Wisdom("file") (or with the environment variable ASU_FFTW_WISDOM set
+ * to a file name), the wisdom in that file is imported before the first
+ * plan is made, and, if planning in this process added to the wisdom,
+ * all wisdom is exported back to it at exit. This way FFTW_MEASURE plans
+ * are measured once per machine instead of once per run. A missing file is
+ * not an error (it is created at exit). Wisdom() called after the first
+ * plan imports the file immediately.
+ *
+ * Many processes can share one wisdom file: the export is written to a
+ * temporary file in the same directory and renamed over the target, so a
+ * reader never imports a partly written file. Processes that learned
+ * nothing new don't write.
+ *
+ * The cached plans are out-of-place and made on fftw_malloc'ed arrays, so
+ * run them with the new-array execute functions on arrays from Real() /
+ * Complex() (or other fftw_malloc'ed arrays):
+ *
+ *     double *In=FFTWPlanCache::Real(N);
+ *     fftw_complex *Out=FFTWPlanCache::Complex(N/2+1);
+ *     ... fill In ...
+ *     fftw_execute_dft_r2c(FFTWPlanCache::R2C(N),In,Out);
+ *
+ * Scratch buffers belong to the calling thread, grow as needed and are
+ * reused by the next call on the same thread and slot. A function using
+ * them should not call another function using the same slots before it
+ * is done with its buffers.
+ *
+ * member function(s):
+ * static fftw_plan R2C(const int &N, const unsigned &flags=FFTW_ESTIMATE)  ----  Real to complex plan, length N.
+ * static fftw_plan C2R(const int &N, const unsigned &flags=FFTW_ESTIMATE)  ----  Complex to real plan, length N.
+ * static double *Real(const size_t &n, const int &slot=0)                 ----  Per-thread real scratch (size >= n).
+ * static fftw_complex *Complex(const size_t &n, const int &slot=0)        ----  Per-thread complex scratch (size >= n).
+ * static void Wisdom(const string &file)                                  ----  Import / export fftw wisdom from / to this file.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Dependence: fftw-3.
+ *
+ * Key words: fftw, plan, cache, thread-safe, scratch.
+*********************************************************************/
+
+class FFTWPlanCache {
+
+    // {length, direction, flags}.
+    typedef std::tuple<int,int,unsigned> Key;
+
+    template<typename T>
+    struct Buffer {
+        T *p=nullptr;
+        std::size_t n=0;
+        ~Buffer() {fftw_free(p);}
+
+        T *Get(const std::size_t &size){
+            if (size<=n) return p;
+            fftw_free(p);
+            p=(T *)fftw_malloc((size>0?size:1)*sizeof(T));
+            n=(p==nullptr?0:size);
+            if (p==nullptr)
+                throw std::runtime_error("FFTWPlanCache: fftw_malloc failed ...");
+            return p;
+        }
+    };
+
+    static const int Slots=4;
+
+    // Persistent wisdom. Guarded by FFTWPlannerMutex.
+    struct WisdomFile {
+        std::string name;
+        bool loaded=false,learned=false;
+        ~WisdomFile() {
+            std::lock_guard<std::mutex> lock(FFTWPlannerMutex());
+            if (!learned || name.empty()) return;
+            std::string tmp=name+".tmp."+std::to_string(getpid());
+            if (!fftw_export_wisdom_to_filename(tmp.c_str()) || std::rename(tmp.c_str(),name.c_str())!=0) {
+                std::remove(tmp.c_str());
+                std::cerr << "Warning in FFTWPlanCache: can't export fftw wisdom to " << name << " ..." << std::endl;
+            }
+        }
+
+        // The planner's current wisdom.
+        static std::string Current() {
+            char *s=fftw_export_wisdom_to_string();
+            if (s==nullptr) return "";
+            std::string ans(s);
+            free(s);
+            return ans;
+        }
+
+        void Load() {
+            if (loaded) return;
+            loaded=true;
+            if (name.empty()) {
+                const char *env=std::getenv("ASU_FFTW_WISDOM");
+                if (env!=nullptr) name=env;
+            }
+            if (!name.empty()) fftw_import_wisdom_from_filename(name.c_str());
+        }
+    };
+
+    // the mutex is made first, so it outlives this object.
+    static WisdomFile &Store() {
+        FFTWPlannerMutex();
+        static WisdomFile ans;
+        return ans;
+    }
+
+    static fftw_plan Plan(const Key &key){
+
+        // per-thread copy of the lookup table (plans are never destroyed).
+        static thread_local std::map<Key,fftw_plan> local;
+        auto it=local.find(key);
+        if (it!=local.end()) return it->second;
+
+        static std::map<Key,fftw_plan> plans;
+        std::lock_guard<std::mutex> lock(FFTWPlannerMutex());
+        auto &ans=plans[key];
+        if (ans==nullptr) {
+            WisdomFile &store=Store();
+            store.Load();
+            // a new plan may not add anything (e.g. it was in the imported wisdom).
+            bool estimate=(std::get<2>(key)==FFTW_ESTIMATE);
+            std::string before=(estimate || store.learned?"":WisdomFile::Current());
+            int N=std::get<0>(key);
+            double *In=(double *)fftw_malloc(N*sizeof(double));
+            fftw_complex *Out=(fftw_complex *)fftw_malloc((N/2+1)*sizeof(fftw_complex));
+            if (In!=nullptr && Out!=nullptr) {
+                if (std::get<1>(key)==FFTW_FORWARD)
+                    ans=fftw_plan_dft_r2c_1d(N,In,Out,std::get<2>(key));
+                else
+                    ans=fftw_plan_dft_c2r_1d(N,Out,In,std::get<2>(key));
+            }
+            fftw_free(In);
+            fftw_free(Out);
+            if (ans==nullptr) {
+                plans.erase(key);
+                throw std::runtime_error("FFTWPlanCache: can't make fftw plan ...");
+            }
+            if (!estimate && !store.learned && WisdomFile::Current()!=before) store.learned=true;
+        }
+        local[key]=ans;
+        return ans;
+    }
+
+public:
+
+    static fftw_plan R2C(const int &N, const unsigned &flags=FFTW_ESTIMATE) {
+        return Plan(Key(N,FFTW_FORWARD,flags));
+    }
+
+    static fftw_plan C2R(const int &N, const unsigned &flags=FFTW_ESTIMATE) {
+        return Plan(Key(N,FFTW_BACKWARD,flags));
+    }
+
+    static double *Real(const std::size_t &n, const int &slot=0) {
+        static thread_local Buffer<double> buf[Slots];
+        return buf[slot].Get(n);
+    }
+
+    static fftw_complex *Complex(const std::size_t &n, const int &slot=0) {
+        static thread_local Buffer<fftw_complex> buf[Slots];
+        return buf[slot].Get(n);
+    }
+
+    static void Wisdom(const std::string &file) {
+        std::lock_guard<std::mutex> lock(FFTWPlannerMutex());
+        WisdomFile &store=Store();
+        store.name=file;
+        store.loaded=false;
+        store.Load();
+    }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef ASU_FFTWPLANNERMUTEX
+#define ASU_FFTWPLANNERMUTEX
+
+#include<mutex>
+
+/***********************************************************
+ * This C++ function returns the mutex guarding the fftw
+ * planner.
+ *
+ * Only fftw_execute* are thread-safe in fftw-3. Any other fftw call
+ * (fftw_plan_*, fftw_destroy_plan, wisdom functions) made from code that
+ * may run in parallel should hold this lock:
+ *
+ *     std::lock_guard<std::mutex> lock(FFTWPlannerMutex());
+ *     fftw_plan p=fftw_plan_dft_r2c_1d(N,In,Out,FFTW_ESTIMATE);
+ *
+ * return(s):
+ * std::mutex &ans  ----  The process-wide planner mutex.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: fftw, thread-safe, planner, mutex.
+***********************************************************/
+
+inline std::mutex &FFTWPlannerMutex(){
+    static std::mutex ans;
+    return ans;
+}
+
+#endif
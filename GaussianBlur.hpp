@@ -4,6 +4,7 @@
 #include<iostream>
 #include<vector>
 #include<cmath>
+#include<array>
 
 #include<Convolve.hpp>
 #include<GaussianSignal.hpp>
@@ -18,6 +19,14 @@
  * is chosen so that at the end points the amplitude is 0.1%
  * of the amplitude at the peak.
  *
+ * Recursive mode: instead of convolving, run a recursive gaussian
+ * filter (Young & van Vliet, 1995) forward and backward. The cost per
+ * sample doesn't depend on sigma. Near the ends, the result is divided by
+ * the blurred 1s, i.e. like the normalized truncation of the convolution.
+ * The recursive impulse response is within a few percent (of the peak)
+ * of the gaussian, and has no length limit (minLen50 is ignored). For
+ * sigma shorter than two samples, the convolution is used.
+ *
  * inputs(s):
  * vector<vector<T>> &p      ----  Input 2D array pointer.
  * const double      &dt     ----  Sampling rate (in sec.)
@@ -25,6 +34,9 @@
  * const bool        &minLen50  ----  (Optional, default is false)
  *                                    true:  the result signal is at leat 50 seconds long.
  *                                    false: the result signal length is adaptive, stops when amplitude hit 1e-3.
+ * const bool        &Recursive ----  (Optional, default is false)
+ *                                    true:  use the recursive filter.
+ *                                    false: convolve with the gaussian signal.
  *
  * return(s):
  * vector<T> &p (in-place)
@@ -35,8 +47,50 @@
  * Key words: gaussian, blur, low pass filter.
 ***********************************************************/
 
+namespace GaussianBlurHidden {
+
+    // Young & van Vliet coefficients for sigma s (in samples, s>=0.5):
+    // {B,c1,c2,c3}, w[n]=B*x[n]+c1*w[n-1]+c2*w[n-2]+c3*w[n-3].
+    inline std::array<double,4> Coefficients(const double &s){
+        double q=(s>=2.5?0.98711*s-0.96330:3.97156-4.14554*std::sqrt(1-0.26891*s));
+        double q2=q*q,q3=q2*q;
+        double b0=1.57825+2.44413*q+1.4281*q2+0.422205*q3;
+        double c1=(2.44413*q+2.85619*q2+1.26661*q3)/b0,c2=-(1.4281*q2+1.26661*q3)/b0,c3=0.422205*q3/b0;
+        return {{1-c1-c2-c3,c1,c2,c3}};
+    }
+
+    // Forward then backward pass, zero outside x. The backward pass starts
+    // from the exact continuation of the forward pass (Triggs & Sdika, 2006).
+    inline void Recursive(std::vector<double> &x, const std::array<double,4> &c){
+
+        int n=x.size();
+        double B=c[0],a1=c[1],a2=c[2],a3=c[3];
+
+        double w1=0,w2=0,w3=0;
+        for (int i=0;i<n;++i) {
+            double w=B*x[i]+a1*w1+a2*w2+a3*w3;
+            w3=w2;w2=w1;w1=w;
+            x[i]=w;
+        }
+
+        // y[n-1], y[n], y[n+1] from the forward state.
+        double s=B/((1+a1-a2+a3)*(1-a1-a2-a3)*(1+a2+(a1-a3)*a3));
+        double y1=s*((1-a1*a3-a3*a3-a2)*w1+(a3+a1)*(a2+a3*a1)*w2+a3*(a1+a3*a2)*w3);
+        double y2=s*((a1+a3*a2)*w1-(a2-1)*(a2+a3*a1)*w2-a3*(a3*a1+a3*a3+a2-1)*w3);
+        double y3=s*((a3*a1+a2+a1*a1-a2*a2)*w1+(a1*a2+a3*a2*a2-a1*a3*a3-a3*a3*a3-a3*a2+a3)*w2+a3*(a1+a3*a2)*w3);
+
+        x[n-1]=y1;
+        for (int i=n-2;i>=0;--i) {
+            double y=B*x[i]+a1*y1+a2*y2+a3*y3;
+            y3=y2;y2=y1;y1=y;
+            x[i]=y;
+        }
+    }
+}
+
 template<typename T>
-void GaussianBlur(std::vector<T> &p, const double &dt, const double &sigma, const bool &minLen50=false){
+void GaussianBlur(std::vector<T> &p, const double &dt, const double &sigma, const bool &minLen50=false,
+                  const bool &Recursive=false){
 
     // Check p size.
     if (p.empty()) return;
@@ -47,6 +101,15 @@ void GaussianBlur(std::vector<T> &p, const double &dt, const double &sigma, cons
         return;
     }
 
+    if (Recursive && sigma>=2*dt) {
+        auto c=GaussianBlurHidden::Coefficients(sigma/dt);
+        std::vector<double> x(p.begin(),p.end()),w(p.size(),1);
+        GaussianBlurHidden::Recursive(x,c);
+        GaussianBlurHidden::Recursive(w,c);
+        for (std::size_t i=0;i<p.size();++i) p[i]=x[i]/w[i];
+        return;
+    }
+
     // Gaussian signal length.
     double GaussianLength=2*sigma*sqrt(2*log(1000));
     if (minLen50)
@@ -58,7 +121,8 @@ void GaussianBlur(std::vector<T> &p, const double &dt, const double &sigma, cons
 
     // Convolve input signals with guassian function.
     // Truncate the smoothed signals into original size (keep the center part.)
-    p=Convolve(p,Gaussian,true,true);
+    auto ans=Convolve(p,Gaussian,true,true);
+    p.assign(ans.begin(),ans.end());
 
     return;
 }
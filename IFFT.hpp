@@ -9,6 +9,8 @@ extern "C"{
 #include<fftw3.h>
 }
 
+#include<FFTWPlanCache.hpp>
+
 /*********************************************************************
  * This C++ template runs ifft on input amplitude and phase vector
  * (same length) which is obtained by *real* signal FFT, then return the
@@ -40,11 +42,8 @@ IFFT(const std::vector<T1> &amp, const std::vector<T2> &phase, const double &df)
 
     int n=amp.size(),N=2*(n-1);
 
-    double *In = new double [N];
-    fftw_complex *Out=(fftw_complex *)fftw_malloc(n*sizeof(fftw_complex));;
-
-    // Define ifft transform plan.
-    fftw_plan p=fftw_plan_dft_c2r_1d(N,Out,In,FFTW_MEASURE);
+    double *In=FFTWPlanCache::Real(N);
+    fftw_complex *Out=FFTWPlanCache::Complex(n);
 
     // Push data into the plan.
     for (int i=0;i<n;++i) {
@@ -53,15 +52,10 @@ IFFT(const std::vector<T1> &amp, const std::vector<T2> &phase, const double &df)
     }
 
     // Run ifft.
-    fftw_execute(p);
+    fftw_execute_dft_c2r(FFTWPlanCache::C2R(N,FFTW_MEASURE),Out,In);
     std::vector<double> ans;
     for (int i=0;i<N;++i) ans.push_back(In[i]);
 
-    // free resources.
-    fftw_destroy_plan(p);
-    fftw_free(Out);
-    delete [] In;
-
     return ans;
 }
 
@@ -0,0 +1,97 @@
+#ifndef ASU_LRUCACHE
+#define ASU_LRUCACHE
+
+#include<list>
+#include<mutex>
+#include<utility>
+#include<functional>
+#include<unordered_map>
+
+/*************************************************************
+ * This C++ template class is a thread-safe least-recently-used
+ * cache bounded by a byte budget.
+ *
+ * Each value's cost (in bytes) is given by a user function. When the
+ * total cost exceeds the budget, the least recently used values are
+ * evicted. Values larger than the budget are never cached.
+ *
+ * Get() copies the value out, so the result stays valid after the
+ * entry is evicted by other threads.
+ *
+ * constructor input(s):
+ * const size_t &budget  ----  Byte budget.
+ * function     cost     ----  Cost of a value (in bytes).
+ *
+ * member function(s):
+ * bool Get(const K &key, V &value)        ----  Return false if key is not cached.
+ * void Put(const K &key, const V &value)  ----  Insert (or refresh) a value.
+ * void Clear()                            ----  Remove all values.
+ * size_t Bytes() const / Budget() const   ----  Current cost / Byte budget.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: cache, LRU, least recently used.
+*************************************************************/
+
+template<typename K, typename V>
+class LRUCache {
+
+    std::size_t budget,bytes;
+    std::function<std::size_t(const V &)> cost;
+    std::list<std::pair<K,V>> items;                   // front is the most recently used.
+    std::unordered_map<K,typename std::list<std::pair<K,V>>::iterator> pos;
+    mutable std::mutex mtx;
+
+public:
+
+    LRUCache (const std::size_t &b, const std::function<std::size_t(const V &)> &c) :
+              budget(b), bytes(0), cost(c) {}
+
+    std::size_t Budget() const {return budget;}
+    std::size_t Bytes() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return bytes;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mtx);
+        items.clear();
+        pos.clear();
+        bytes=0;
+    }
+
+    bool Get(const K &key, V &value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it=pos.find(key);
+        if (it==pos.end()) return false;
+        items.splice(items.begin(),items,it->second);
+        value=it->second->second;
+        return true;
+    }
+
+    void Put(const K &key, const V &value) {
+        std::size_t c=cost(value);
+        if (c>budget) return;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it=pos.find(key);
+        if (it!=pos.end()) {
+            bytes-=cost(it->second->second);
+            items.erase(it->second);
+            pos.erase(it);
+        }
+
+        while (!items.empty() && bytes+c>budget) {
+            bytes-=cost(items.back().second);
+            pos.erase(items.back().first);
+            items.pop_back();
+        }
+
+        items.emplace_front(key,value);
+        pos[key]=items.begin();
+        bytes+=c;
+    }
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ASU_NEXTFFTSIZE
+#define ASU_NEXTFFTSIZE
+
+#include<limits>
+
+/***********************************************************
+ * This C++ function returns the smallest 2^a*3^b*5^c which is
+ * no less than n. FFTs of these lengths are fast, use it to choose
+ * the length of a zero-padded FFT.
+ *
+ * input(s):
+ * const int &n  ----  Minimum length.
+ *
+ * return(s):
+ * int ans  ----  Smallest 2^a*3^b*5^c >= n.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: fft, length, padding, smooth number.
+***********************************************************/
+
+inline int NextFFTSize(const int &n){
+    int ans=std::numeric_limits<int>::max();
+    for (long long a=1;a<2LL*n;a*=2)
+        for (long long b=a;b<2LL*n;b*=3)
+            for (long long c=b;c<2LL*n;c*=5)
+                if (c>=n && c<ans) ans=c;
+    return (n<=1?1:ans);
+}
+
+#endif
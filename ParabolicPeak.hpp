@@ -0,0 +1,43 @@
+#ifndef ASU_PARABOLICPEAK
+#define ASU_PARABOLICPEAK
+
+#include<vector>
+
+/**************************************************************
+ * This C++ template refines a peak (or trough) position of a
+ * sampled function to sub-sample precision, by fitting a parabola
+ * through the peak sample and its two neighbours.
+ *
+ * If the peak is at either end of the array, or the three samples are
+ * on a line, the peak sample itself is returned.
+ *
+ * input(s):
+ * const vector<T>   &p  ----  Input array.
+ * const std::size_t &i  ----  Peak (or trough) position.
+ *
+ * return(s):
+ * pair<double,double> ans  ----  {position,value}
+ *                                position: refined peak position (in samples, between i-0.5 and i+0.5).
+ *                                value   : parabola value at this position.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: peak position, sub-sample, parabolic interpolation.
+**************************************************************/
+
+template <typename T>
+std::pair<double,double> ParabolicPeak(const std::vector<T> &p, const std::size_t &i){
+
+    if (i>=p.size()) return {0.0/0.0,0.0/0.0};
+    if (i==0 || i+1==p.size()) return {1.0*i,1.0*p[i]};
+
+    double a=p[i-1],b=p[i],c=p[i+1],d=a-2*b+c;
+    if (d==0) return {1.0*i,b};
+
+    double dx=0.5*(a-c)/d;
+    if (dx<-0.5 || dx>0.5) return {1.0*i,b};
+    return {i+dx,b-0.25*(a-c)*dx};
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef ASU_PARALLELFOR
+#define ASU_PARALLELFOR
+
+#include<vector>
+#include<thread>
+#include<atomic>
+#include<mutex>
+#include<exception>
+
+/*************************************************************
+ * This C++ template runs f(i) for i in [0,n) using nThreads
+ * threads. Indices are handed out one at a time, so uneven work
+ * loads (e.g. files of different sizes) are balanced automatically.
+ *
+ * f(i) for different i must be independent (e.g. each i only writes
+ * to its own slot of a pre-allocated output array), then the result
+ * doesn't depend on the number of threads.
+ *
+ * If any f(i) throws, the remaining indices are skipped and the first
+ * exception is re-thrown in the calling thread.
+ *
+ * input(s):
+ * const size_t &n         ----  Number of tasks.
+ * const size_t &nThreads  ----  Number of threads.
+ *                               0: use std::thread::hardware_concurrency().
+ *                               1: run serially in the calling thread.
+ * const F      &f         ----  Task function, called as f(i).
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Dependence: pthread (compile with -pthread).
+ *
+ * Key words: parallel, thread, for loop.
+*************************************************************/
+
+template<typename F>
+void ParallelFor(const std::size_t &n, const std::size_t &nThreads, const F &f){
+
+    std::size_t N=(nThreads==0?std::thread::hardware_concurrency():nThreads);
+    if (N>n) N=n;
+
+    if (N<=1) {
+        for (std::size_t i=0;i<n;++i) f(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr err=nullptr;
+    std::mutex err_mutex;
+
+    auto worker=[&](){
+        std::size_t i;
+        while (!failed && (i=next++)<n) {
+            try {
+                f(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(err_mutex);
+                if (!err) err=std::current_exception();
+                failed=true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t i=1;i<N;++i) pool.emplace_back(worker);
+    worker();
+    for (auto &item:pool) item.join();
+
+    if (err) std::rethrow_exception(err);
+}
+
+#endif
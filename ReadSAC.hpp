@@ -0,0 +1,107 @@
+#ifndef ASU_READSAC
+#define ASU_READSAC
+
+#include<string>
+#include<vector>
+#include<cstring>
+#include<cstdint>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+#include<SACHeader.hpp>
+
+/*************************************************************
+ * This C++ template reads a binary SAC file without using the
+ * SAC library (rsac1/getfhv/getkhv).
+ *
+ * The file is memory-mapped, the 632-byte header is parsed in one
+ * pass (byte order is detected from nvhdr, see SACHeader.hpp) and the
+ * float samples are converted directly into the output array. There
+ * is no limit on npts and no global state, so it is safe to call from
+ * multiple threads.
+ *
+ * If amp is not given, only the header is read (632 bytes).
+ *
+ * input(s):
+ * const string &infile  ----  SAC file name.
+ * SACHeader    &hdr     ----  Header of the file (output).
+ * vector<T>    &amp     ----  (Optional) Samples of the file (output).
+ *
+ * return(s):
+ * bool ans  ----  true : success.
+ *                 false: can't open the file, file is not SAC format,
+ *                        file is truncated, or file is unevenly sampled
+ *                        (these are the records rsac1 refuses to read).
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: sac, read, binary, mmap, endian.
+*************************************************************/
+
+bool ReadSAC(const std::string &infile, SACHeader &hdr){
+
+    int fd=open(infile.c_str(),O_RDONLY);
+    if (fd<0) return false;
+
+    char buf[sizeof(SACHeader)];
+    ssize_t nread=pread(fd,buf,sizeof(SACHeader),0);
+    close(fd);
+
+    if (nread!=(ssize_t)sizeof(SACHeader)) return false;
+    if (SACHeader::Parse(buf,hdr)<0) return false;
+    return (hdr.GetInt("leven")==1 && hdr.GetInt("npts")>=0);
+}
+
+template<typename T>
+bool ReadSAC(const std::string &infile, SACHeader &hdr, std::vector<T> &amp){
+
+    int fd=open(infile.c_str(),O_RDONLY);
+    if (fd<0) return false;
+
+    struct stat st;
+    if (fstat(fd,&st)!=0 || st.st_size<(off_t)sizeof(SACHeader)) {
+        close(fd);
+        return false;
+    }
+
+    std::size_t len=st.st_size;
+    void *p=mmap(nullptr,len,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (p==MAP_FAILED) return false;
+    madvise(p,len,MADV_SEQUENTIAL);
+
+    const char *buf=static_cast<const char *>(p);
+    int swapped=SACHeader::Parse(buf,hdr);
+    int npts=hdr.GetInt("npts");
+
+    if (swapped<0 || hdr.GetInt("leven")!=1 || npts<0 ||
+        sizeof(SACHeader)+sizeof(float)*(std::size_t)npts>len) {
+        munmap(p,len);
+        return false;
+    }
+
+    // Convert samples. (data section starts right after the header, 4-byte aligned)
+    amp.resize(npts);
+    const char *data=buf+sizeof(SACHeader);
+    if (swapped==0) {
+        const float *x=reinterpret_cast<const float *>(data);
+        for (int i=0;i<npts;++i) amp[i]=x[i];
+    }
+    else {
+        const uint32_t *x=reinterpret_cast<const uint32_t *>(data);
+        for (int i=0;i<npts;++i) {
+            uint32_t u=__builtin_bswap32(x[i]);
+            float v;
+            memcpy(&v,&u,sizeof(float));
+            amp[i]=v;
+        }
+    }
+
+    munmap(p,len);
+    return true;
+}
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef ASU_SACARCHIVE
+#define ASU_SACARCHIVE
+
+#include<iostream>
+#include<fstream>
+#include<string>
+#include<vector>
+#include<map>
+#include<cmath>
+#include<cstring>
+#include<cstdint>
+#include<limits>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+#include<EvenSampledSignal.hpp>
+#include<SACMetaData.hpp>
+
+/*************************************************************
+ * This is a single-file container for many waveforms and their
+ * SACMetaData, designed to be memory-mapped.
+ *
+ * Layout (native byte order, a byte order mark is checked on read):
+ *
+ *     [ 64-byte file header ]
+ *     [ sample block 0 ] [ sample block 1 ] ...   (doubles, 64-byte aligned)
+ *     [ columnar header table ]                  (one column per field, n entries each)
+ *     [ phase name table ] [ travel time columns, one per phase (NaN: absent) ]
+ *     [ string pool ]                            (station, network, file names)
+ *
+ * The table is written after the samples, so records can be appended one
+ * by one (Writer::Add) without knowing their lengths in advance.
+ *
+ * Reading (Reader) maps the file; only the header table and the sample
+ * blocks of the requested records are touched.
+ *
+ * Writer member function(s):
+ * Writer(const string &outfile)                           ----  Create an archive.
+ * void Add(const EvenSampledSignal &s, const SACMetaData &m)  ----  Append a record.
+ * void Close()                                            ----  Write the tables. (also called by the destructor)
+ *
+ * Reader member function(s):
+ * Reader(const string &infile)                 ----  Map an archive. (throws if it isn't one)
+ * size_t Size() const                          ----  Number of records.
+ * size_t NPTS(const size_t &i) const           ----  Samples of record i.
+ * SACMetaData MetaData(const size_t &i) const  ----  Meta data of record i.
+ * EvenSampledSignal Signal(const size_t &i) const  ----  Waveform of record i.
+ *
+ * bool IsArchive(const string &infile)  ----  Check the magic bytes.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: archive, container, mmap, columnar, sac.
+*************************************************************/
+
+namespace SACArchive {
+
+    const char Magic[9]="SACARCH1";
+    const uint32_t ByteOrderMark=0x01020304;
+    const uint32_t Version=1;
+
+    namespace Hidden {
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t bom,version;
+            uint64_t n,nPhase,tableOffset,stringOffset,stringBytes,unused;
+        };
+
+        // Fixed columns of the header table, each has n 8-byte entries.
+        enum Column {NPTS,OFFSET,DELTA,BEGIN,GCARC,AZ,EVDE,EVLO,EVLA,STLO,STLA,
+                     STNM_OFF,STNM_LEN,NET_OFF,NET_LEN,FILE_OFF,FILE_LEN,NCOLUMNS};
+
+        const std::size_t Alignment=64;
+
+        inline uint64_t Align(const uint64_t &x) {return (x+Alignment-1)/Alignment*Alignment;}
+    }
+
+    bool IsArchive(const std::string &infile) {
+        std::ifstream fpin(infile,std::ios::binary);
+        char buf[8];
+        if (!fpin.read(buf,8)) return false;
+        return memcmp(buf,Magic,8)==0;
+    }
+
+    class Writer {
+
+        std::ofstream fpout;
+        uint64_t pos;
+        std::vector<std::vector<uint64_t>> icol;        // integer columns.
+        std::vector<std::vector<double>> dcol;          // double columns.
+        std::map<std::string,std::vector<double>> tt;   // travel time columns.
+        std::string pool;
+
+        void Pad(const uint64_t &target) {
+            static const char zeros[Hidden::Alignment]={0};
+            if (target>pos) fpout.write(zeros,target-pos);
+            pos=target;
+        }
+
+        void WriteSamples(const std::vector<double> &x) {
+            fpout.write(reinterpret_cast<const char *>(x.data()),x.size()*sizeof(double));
+        }
+
+        template<typename T>
+        void WriteSamples(const std::vector<T> &x) {
+            WriteSamples(std::vector<double> (x.begin(),x.end()));
+        }
+
+        void AddString(const std::string &s, const Hidden::Column &c1, const Hidden::Column &c2) {
+            icol[c1].push_back(pool.size());
+            icol[c2].push_back(s.size());
+            pool+=s;
+        }
+
+    public:
+
+        Writer (const std::string &outfile) : fpout(outfile,std::ios::binary), pos(0),
+                                              icol(Hidden::NCOLUMNS), dcol(Hidden::NCOLUMNS) {
+            if (!fpout)
+                throw std::runtime_error("Can't create archive "+outfile+" ...");
+            Hidden::FileHeader h;
+            memset(&h,0,sizeof(h));
+            fpout.write(reinterpret_cast<const char *>(&h),sizeof(h));   // place holder.
+            pos=sizeof(h);
+        }
+
+        Writer (const Writer &item) = delete;
+        Writer &operator=(const Writer &item) = delete;
+
+        ~Writer () {
+            try {Close();}
+            catch (...) {std::cerr << "Error in SACArchive::Writer: failed to close archive ..." << std::endl;}
+        }
+
+        template<typename T>
+        void Add(const BasicEvenSampledSignal<T> &s, const SACMetaData &m) {
+            if (!fpout.is_open())
+                throw std::runtime_error("SACArchive::Writer is already closed ...");
+
+            using namespace Hidden;
+            std::size_t n=icol[NPTS].size();
+
+            Pad(Align(pos));
+            icol[NPTS].push_back(s.Size());
+            icol[OFFSET].push_back(pos);
+            WriteSamples(s.GetAmp());
+            pos+=s.Size()*sizeof(double);
+
+            dcol[DELTA].push_back(s.GetDelta());
+            dcol[BEGIN].push_back(s.BeginTime());
+            dcol[GCARC].push_back(m.gcarc);
+            dcol[AZ].push_back(m.az);
+            dcol[EVDE].push_back(m.evde);
+            dcol[EVLO].push_back(m.evlo);
+            dcol[EVLA].push_back(m.evla);
+            dcol[STLO].push_back(m.stlo);
+            dcol[STLA].push_back(m.stla);
+            AddString(m.stnm,STNM_OFF,STNM_LEN);
+            AddString(m.network,NET_OFF,NET_LEN);
+            AddString(s.GetFileName(),FILE_OFF,FILE_LEN);
+
+            // new phases get NaN for previous records.
+            for (const auto &item:m.tt)
+                if (tt.find(item.first)==tt.end())
+                    tt[item.first]=std::vector<double>(n,0.0/0.0);
+            for (auto &item:tt) {
+                auto it=m.tt.find(item.first);
+                item.second.push_back(it==m.tt.end()?0.0/0.0:it->second);
+            }
+        }
+
+        void Close() {
+            if (!fpout.is_open()) return;
+
+            using namespace Hidden;
+            std::size_t n=icol[NPTS].size();
+
+            // columnar header table.
+            Pad(Align(pos));
+            uint64_t tableOffset=pos;
+            for (std::size_t c=0;c<NCOLUMNS;++c) {
+                if (icol[c].size()==n)
+                    fpout.write(reinterpret_cast<const char *>(icol[c].data()),n*sizeof(uint64_t));
+                else
+                    fpout.write(reinterpret_cast<const char *>(dcol[c].data()),n*sizeof(double));
+            }
+            pos+=NCOLUMNS*n*8;
+
+            // phase names (offset, length into the string pool), then travel time columns.
+            for (const auto &item:tt) {
+                uint64_t x[2]={pool.size(),item.first.size()};
+                fpout.write(reinterpret_cast<const char *>(x),sizeof(x));
+                pool+=item.first;
+            }
+            pos+=tt.size()*16;
+            for (const auto &item:tt)
+                fpout.write(reinterpret_cast<const char *>(item.second.data()),n*sizeof(double));
+            pos+=tt.size()*n*8;
+
+            // string pool.
+            uint64_t stringOffset=pos;
+            fpout.write(pool.data(),pool.size());
+            pos+=pool.size();
+
+            // file header.
+            FileHeader h;
+            memset(&h,0,sizeof(h));
+            memcpy(h.magic,Magic,8);
+            h.bom=ByteOrderMark;
+            h.version=Version;
+            h.n=n;
+            h.nPhase=tt.size();
+            h.tableOffset=tableOffset;
+            h.stringOffset=stringOffset;
+            h.stringBytes=pool.size();
+            fpout.seekp(0);
+            fpout.write(reinterpret_cast<const char *>(&h),sizeof(h));
+            fpout.close();
+
+            if (!fpout)
+                throw std::runtime_error("Error in SACArchive::Writer: failed to write archive ...");
+        }
+    };
+
+    class Reader {
+
+        void *p;
+        std::size_t len;
+        Hidden::FileHeader h;
+        std::vector<std::string> phases;
+
+        const char *Base() const {return static_cast<const char *>(p);}
+
+        template<typename T>
+        T Column(const Hidden::Column &c, const std::size_t &i) const {
+            T ans;
+            memcpy(&ans,Base()+h.tableOffset+(c*h.n+i)*8,sizeof(T));
+            return ans;
+        }
+
+        std::string String(const Hidden::Column &c1, const Hidden::Column &c2, const std::size_t &i) const {
+            return std::string(Base()+h.stringOffset+Column<uint64_t>(c1,i),Column<uint64_t>(c2,i));
+        }
+
+        void CheckIndex(const std::size_t &i) const {
+            if (i>=Size())
+                throw std::runtime_error("SACArchive record index out of range: "+std::to_string(i));
+        }
+
+    public:
+
+        Reader (const std::string &infile) : p(MAP_FAILED), len(0) {
+
+            int fd=open(infile.c_str(),O_RDONLY);
+            if (fd<0)
+                throw std::runtime_error("Can't open archive "+infile+" ...");
+
+            struct stat st;
+            if (fstat(fd,&st)==0 && st.st_size>=(off_t)sizeof(h)) {
+                len=st.st_size;
+                p=mmap(nullptr,len,PROT_READ,MAP_PRIVATE,fd,0);
+            }
+            close(fd);
+
+            if (p==MAP_FAILED)
+                throw std::runtime_error("Can't map archive "+infile+" ...");
+
+            memcpy(&h,p,sizeof(h));
+            if (memcmp(h.magic,Magic,8)!=0 || h.bom!=ByteOrderMark || h.version!=Version ||
+                h.tableOffset+(Hidden::NCOLUMNS*h.n+2*h.nPhase+h.nPhase*h.n)*8>h.stringOffset ||
+                h.stringOffset+h.stringBytes>len) {
+                munmap(p,len);
+                throw std::runtime_error(infile+" is not a SACArchive (or has different byte order) ...");
+            }
+
+            // only touch the pages we need.
+            madvise(p,len,MADV_RANDOM);
+
+            const char *q=Base()+h.tableOffset+Hidden::NCOLUMNS*h.n*8;
+            for (std::size_t j=0;j<h.nPhase;++j) {
+                uint64_t x[2];
+                memcpy(x,q+16*j,sizeof(x));
+                phases.push_back(std::string(Base()+h.stringOffset+x[0],x[1]));
+            }
+        }
+
+        Reader (const Reader &item) = delete;
+        Reader &operator=(const Reader &item) = delete;
+
+        ~Reader () {munmap(p,len);}
+
+        std::size_t Size() const {return h.n;}
+
+        std::size_t NPTS(const std::size_t &i) const {
+            CheckIndex(i);
+            return Column<uint64_t>(Hidden::NPTS,i);
+        }
+
+        SACMetaData MetaData(const std::size_t &i) const {
+            using namespace Hidden;
+            CheckIndex(i);
+
+            std::map<std::string,double> tt;
+            const char *q=Base()+h.tableOffset+NCOLUMNS*h.n*8+16*h.nPhase;
+            for (std::size_t j=0;j<h.nPhase;++j) {
+                double t;
+                memcpy(&t,q+(j*h.n+i)*8,sizeof(double));
+                if (!std::isnan(t)) tt[phases[j]]=t;
+            }
+
+            return SACMetaData(String(STNM_OFF,STNM_LEN,i),String(NET_OFF,NET_LEN,i),
+                               Column<double>(GCARC,i),Column<double>(AZ,i),Column<double>(EVDE,i),
+                               Column<double>(EVLO,i),Column<double>(EVLA,i),
+                               Column<double>(STLO,i),Column<double>(STLA,i),tt);
+        }
+
+        EvenSampledSignal Signal(const std::size_t &i) const {
+            using namespace Hidden;
+            CheckIndex(i);
+
+            uint64_t npts=Column<uint64_t>(Hidden::NPTS,i),offset=Column<uint64_t>(OFFSET,i);
+            if (offset+npts*sizeof(double)>len)
+                throw std::runtime_error("SACArchive record "+std::to_string(i)+" is truncated ...");
+
+            const double *x=reinterpret_cast<const double *>(Base()+offset);
+            return EvenSampledSignal(std::vector<double>(x,x+npts),Column<double>(DELTA,i),
+                                     Column<double>(BEGIN,i),String(FILE_OFF,FILE_LEN,i));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef ASU_SACHEADER
+#define ASU_SACHEADER
+
+#include<string>
+#include<cstring>
+#include<cstdint>
+#include<cctype>
+#include<map>
+
+/*************************************************************
+ * This C++ struct holds the 632-byte binary header of a SAC
+ * file, laid out exactly as on disk:
+ *
+ *     70 floats  (f)  --  delta, b, t0-t9, gcarc, ...
+ *     40 ints    (n)  --  npts, nvhdr, iftype, leven, ...
+ *     192 chars  (k)  --  kstnm, kevnm, kt0-kt9, knetwk, ...
+ *
+ * Values are accessed by their SAC header names (case-insensitive),
+ * mimicking getfhv/getkhv/setfhv etc. of the SAC library, but without
+ * its global state: every SACHeader object is independent, so they are
+ * safe to use from multiple threads.
+ *
+ * Undefined values follow the SAC convention:
+ *     float/int : -12345
+ *     char      : "-12345  "
+ *     logical   : 0 (false)
+ *
+ * Parse(buf,hdr) copies a header from a memory buffer, detecting the
+ * byte order from the header version number (nvhdr).
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: sac, header, binary, endian.
+*************************************************************/
+
+struct SACHeader {
+
+    float f[70];
+    int n[40];
+    char k[192];
+
+    SACHeader () {Clear();}
+
+    // Set all values to undefined (same as SAC's "newhdr").
+    void Clear() {
+        for (std::size_t i=0;i<70;++i) f[i]=-12345;
+        for (std::size_t i=0;i<40;++i) n[i]=-12345;
+        for (std::size_t i=0;i<192;i+=8) memcpy(k+i,"-12345  ",8);
+        n[6]=6;                                  // nvhdr.
+        n[15]=1;                                 // iftype = itime.
+        n[35]=1;                                 // leven  = true.
+        n[36]=0;                                 // lpspol = false.
+        n[37]=1;                                 // lovrok = true.
+        n[38]=1;                                 // lcalda = true.
+        n[39]=0;
+    }
+
+    float GetFloat(const std::string &name) const {
+        auto it=FloatIndex().find(Lower(name));
+        return (it==FloatIndex().end()?-12345:f[it->second]);
+    }
+
+    int GetInt(const std::string &name) const {
+        auto it=IntIndex().find(Lower(name));
+        return (it==IntIndex().end()?-12345:n[it->second]);
+    }
+
+    // Return the raw field (8 or 16 chars), stop at the first '\0'.
+    std::string GetKey(const std::string &name) const {
+        auto it=KeyIndex().find(Lower(name));
+        if (it==KeyIndex().end()) return "-12345";
+        const char *p=k+it->second.first;
+        return std::string(p,strnlen(p,it->second.second));
+    }
+
+    bool SetFloat(const std::string &name, const float &v) {
+        auto it=FloatIndex().find(Lower(name));
+        if (it==FloatIndex().end()) return false;
+        f[it->second]=v;
+        return true;
+    }
+
+    bool SetInt(const std::string &name, const int &v) {
+        auto it=IntIndex().find(Lower(name));
+        if (it==IntIndex().end()) return false;
+        n[it->second]=v;
+        return true;
+    }
+
+    // Pad with blanks (truncate if too long), same as SAC's setkhv.
+    bool SetKey(const std::string &name, const std::string &v) {
+        auto it=KeyIndex().find(Lower(name));
+        if (it==KeyIndex().end()) return false;
+        char *p=k+it->second.first;
+        std::size_t len=it->second.second;
+        for (std::size_t i=0;i<len;++i) p[i]=(i<v.size()?v[i]:' ');
+        return true;
+    }
+
+    // Copy a header from buf (at least 632 bytes).
+    // return: -1 (not a SAC header), 0 (native byte order), 1 (byte swapped).
+    static int Parse(const char *buf, SACHeader &hdr) {
+        memcpy(&hdr,buf,sizeof(SACHeader));
+        if (ValidVersion(hdr.n[6])) return 0;
+
+        // try the other byte order.
+        uint32_t *p=reinterpret_cast<uint32_t *>(&hdr);
+        for (std::size_t i=0;i<110;++i) p[i]=__builtin_bswap32(p[i]);
+        if (ValidVersion(hdr.n[6])) return 1;
+        return -1;
+    }
+
+private:
+
+    static bool ValidVersion(const int &v) {return (1<=v && v<=7);}
+
+    static std::string Lower(std::string s) {
+        for (auto &c:s) c=tolower(c);
+        return s;
+    }
+
+    static const std::map<std::string,std::size_t> &FloatIndex() {
+        static const std::map<std::string,std::size_t> M=[](){
+            std::map<std::string,std::size_t> ans{
+                {"delta",0},{"depmin",1},{"depmax",2},{"scale",3},{"odelta",4},
+                {"b",5},{"e",6},{"o",7},{"a",8},{"f",20},
+                {"stla",31},{"stlo",32},{"stel",33},{"stdp",34},
+                {"evla",35},{"evlo",36},{"evel",37},{"evdp",38},{"mag",39},
+                {"dist",50},{"az",51},{"baz",52},{"gcarc",53},{"depmen",56},
+                {"cmpaz",57},{"cmpinc",58}};
+            for (std::size_t i=0;i<10;++i) {
+                ans["t"+std::to_string(i)]=10+i;
+                ans["resp"+std::to_string(i)]=21+i;
+                ans["user"+std::to_string(i)]=40+i;
+            }
+            return ans;
+        }();
+        return M;
+    }
+
+    static const std::map<std::string,std::size_t> &IntIndex() {
+        static const std::map<std::string,std::size_t> M{
+            {"nzyear",0},{"nzjday",1},{"nzhour",2},{"nzmin",3},{"nzsec",4},{"nzmsec",5},
+            {"nvhdr",6},{"norid",7},{"nevid",8},{"npts",9},{"nwfid",11},
+            {"iftype",15},{"idep",16},{"iztype",17},{"iinst",19},{"istreg",20},{"ievreg",21},
+            {"ievtyp",22},{"iqual",23},{"isynth",24},{"imagtyp",25},{"imagsrc",26},
+            {"leven",35},{"lpspol",36},{"lovrok",37},{"lcalda",38}};
+        return M;
+    }
+
+    // {offset, length} in the char header.
+    static const std::map<std::string,std::pair<std::size_t,std::size_t>> &KeyIndex() {
+        static const std::map<std::string,std::pair<std::size_t,std::size_t>> M=[](){
+            std::map<std::string,std::pair<std::size_t,std::size_t>> ans{
+                {"kstnm",{0,8}},{"kevnm",{8,16}},{"khole",{24,8}},{"ko",{32,8}},{"ka",{40,8}},
+                {"kf",{128,8}},{"kuser0",{136,8}},{"kuser1",{144,8}},{"kuser2",{152,8}},
+                {"kcmpnm",{160,8}},{"knetwk",{168,8}},{"kdatrd",{176,8}},{"kinst",{184,8}}};
+            for (std::size_t i=0;i<10;++i)
+                ans["kt"+std::to_string(i)]={48+8*i,8};
+            return ans;
+        }();
+        return M;
+    }
+};
+
+#endif
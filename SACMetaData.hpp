@@ -0,0 +1,76 @@
+#ifndef ASU_SACMETADATA
+#define ASU_SACMETADATA
+
+#include<iostream>
+#include<string>
+#include<map>
+
+#include<SACHeader.hpp>
+
+/*************************************************************
+ * This C++ struct holds the meta data of a SAC record used by
+ * SACSignals: station, network, distance, azimuth, event and
+ * station locations, and all travel times available in the header.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: sac, meta data, header.
+*************************************************************/
+
+struct SACMetaData{
+    std::string stnm,network;
+    double gcarc,az,evde,evlo,evla,stlo,stla;
+    std::map<std::string,double> tt;           // all travel times avaliable in the sac file header.
+
+    SACMetaData () : SACMetaData("") {}
+
+    SACMetaData (const std::string &s) : SACMetaData(s,"") {}
+
+    SACMetaData (const std::string &s, const std::string &n) : SACMetaData(s,n,0) {}
+
+    SACMetaData (const std::string &s, const std::string &n, const double &g) : SACMetaData(s,n,g,0) {}
+
+    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a) :
+                 SACMetaData(s,n,g,a,0,0,0,0,0) {}
+
+    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a,
+                 const double &ede, const double &elo, const double &ela, const double &slo, const double &sla) :
+                 SACMetaData(s,n,g,a,ede,elo,ela,slo,sla,std::map<std::string, double> ()) {}
+
+    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a,
+                 const double &ede, const double &elo, const double &ela, const double &slo, const double &sla,
+                 const std::map<std::string,double> &m) : stnm(s),network(n),gcarc(g),az(a),
+                                                          evde(ede), evlo(elo), evla(ela), stlo(slo), stla(sla), tt(m) {}
+
+    // From a SAC header. Travel times are pulled from (kt0,t0) ... (kt9,t9).
+    SACMetaData (const SACHeader &hdr) : SACMetaData() {
+        auto firstWord=[](const std::string &s){return s.substr(0,s.find_first_of(" \n\r\t"));};
+        stnm=firstWord(hdr.GetKey("kstnm"));
+        network=firstWord(hdr.GetKey("knetwk"));
+        gcarc=hdr.GetFloat("gcarc");
+        az=hdr.GetFloat("az");
+        evde=hdr.GetFloat("evdp");
+        evlo=hdr.GetFloat("evlo");
+        evla=hdr.GetFloat("evla");
+        stlo=hdr.GetFloat("stlo");
+        stla=hdr.GetFloat("stla");
+        for (std::size_t i=0;i<10;++i) {
+            std::string p=firstWord(hdr.GetKey("kt"+std::to_string(i)));
+            if (p!="-12345") tt[p]=hdr.GetFloat("t"+std::to_string(i));
+        }
+    }
+};
+
+std::ostream &operator<<(std::ostream &os, const SACMetaData &item){
+    os << "Network: |" << item.network << "|\n";
+    os << "StationName: |" << item.stnm << "|\n";
+    os << "Az: |" << item.az << "|\n";
+    os << "Gcarc: |" << item.gcarc << "|\n";
+    os << "TravelTimes: " << '\n';
+    for (const auto &item2:item.tt)
+        os << "    " << item2.first << "  -  " << item2.second << " sec.\n";
+    return os;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef ASU_SACMETATABLE
+#define ASU_SACMETATABLE
+
+#include<vector>
+#include<string>
+#include<cmath>
+#include<limits>
+#include<unordered_map>
+#include<stdexcept>
+
+#include<SACMetaData.hpp>
+#include<ReorderUseIndex.hpp>
+
+/*************************************************************
+ * This C++ class stores the meta data of many SAC records in
+ * columns (one array per field), as used by SACSignals.
+ *
+ * Station and network names are interned: each record keeps an integer
+ * id into a shared name pool. Travel times are kept in a phase
+ * dictionary: each phase name seen maps to a dense column with one
+ * arrival time per record (NaN if the record doesn't have this phase).
+ * A travel time stored as NaN (e.g. read from a SAC header) is therefore
+ * the same as a missing one: Get() leaves it out of SACMetaData::tt, and
+ * SACSignals::CheckPhase and GetTravelTimes treat it as absent.
+ *
+ * Filters over the records are then plain scans over contiguous arrays,
+ * e.g. for CheckPhase:
+ *
+ *     const std::vector<double> *p=table.Phase("S");
+ *     for (std::size_t i=0;i<table.Size();++i) ... (*p)[i] ...
+ *
+ * member function(s):
+ * size_t Size() const                            ----  Number of records.
+ * const vector<double> &Gcarc() const ...        ----  Columns: Gcarc, Az, Evde, Evlo, Evla, Stlo, Stla.
+ * const string &Stnm(i) const / Network(i) const ----  Station / network name of record i.
+ * size_t StnmID(i) const / NetworkID(i) const    ----  Interned name id of record i.
+ * const string &Name(id) const                   ----  Name of an interned id.
+ * const vector<double> *Phase(p) const           ----  Travel time column of phase p (nullptr if no
+ *                                                      record has it).
+ * vector<string> Phases() const                  ----  All phase names in the dictionary.
+ * SACMetaData Get(i) const                       ----  Meta data of record i as a SACMetaData.
+ * void PushBack(const SACMetaData &m)            ----  Append a record.
+ * void SetGcarc(i,v) / SetAz(i,v)                ----  Modify a record.
+ * void ShiftTravelTimes(i,t)                     ----  Subtract t from all travel times of record i.
+ * void Remove(i)                                 ----  Remove record i, the last record moves to i.
+ * void Reorder(const vector<size_t> &idx)        ----  New record k is the old record idx[k].
+ * SACMetaTable Select(const vector<size_t> &idx) ----  A table with records idx.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: sac, meta data, columnar, intern, travel time.
+*************************************************************/
+
+class SACMetaTable {
+
+    std::size_t n=0;
+    std::vector<double> gcarc,az,evde,evlo,evla,stlo,stla;
+    std::vector<std::size_t> stnm,network;                  // interned ids.
+    std::vector<std::string> names;                         // name pool.
+    std::unordered_map<std::string,std::size_t> name_id;
+    std::vector<std::string> phases;
+    std::unordered_map<std::string,std::size_t> phase_id;
+    std::vector<std::vector<double>> tt;                    // tt[phase id][record].
+
+    std::size_t Intern(const std::string &s){
+        auto it=name_id.find(s);
+        if (it!=name_id.end()) return it->second;
+        names.push_back(s);
+        name_id[s]=names.size()-1;
+        return names.size()-1;
+    }
+
+    std::vector<double> &Column(const std::string &p){
+        auto it=phase_id.find(p);
+        if (it!=phase_id.end()) return tt[it->second];
+        phase_id[p]=phases.size();
+        phases.push_back(p);
+        tt.push_back(std::vector<double> (n,std::numeric_limits<double>::quiet_NaN()));
+        return tt.back();
+    }
+
+    // apply f to each per-record column.
+    template<typename F> void ForEachColumn(const F &f){
+        f(gcarc);f(az);f(evde);f(evlo);f(evla);f(stlo);f(stla);
+        f(stnm);f(network);
+        for (auto &item:tt) f(item);
+    }
+
+public:
+
+    std::size_t Size() const {return n;}
+    void Clear() {*this=SACMetaTable();}
+
+    const std::vector<double> &Gcarc() const {return gcarc;}
+    const std::vector<double> &Az() const {return az;}
+    const std::vector<double> &Evde() const {return evde;}
+    const std::vector<double> &Evlo() const {return evlo;}
+    const std::vector<double> &Evla() const {return evla;}
+    const std::vector<double> &Stlo() const {return stlo;}
+    const std::vector<double> &Stla() const {return stla;}
+
+    std::size_t StnmID(const std::size_t &i) const {return stnm[i];}
+    std::size_t NetworkID(const std::size_t &i) const {return network[i];}
+    const std::string &Name(const std::size_t &id) const {return names[id];}
+    const std::string &Stnm(const std::size_t &i) const {return names[stnm[i]];}
+    const std::string &Network(const std::size_t &i) const {return names[network[i]];}
+
+    const std::vector<double> *Phase(const std::string &p) const {
+        auto it=phase_id.find(p);
+        return (it==phase_id.end()?nullptr:&tt[it->second]);
+    }
+    std::vector<std::string> Phases() const {return phases;}
+
+    SACMetaData Get(const std::size_t &i) const {
+        SACMetaData ans(Stnm(i),Network(i),gcarc[i],az[i],evde[i],evlo[i],evla[i],stlo[i],stla[i]);
+        for (std::size_t k=0;k<phases.size();++k)
+            if (!std::isnan(tt[k][i])) ans.tt[phases[k]]=tt[k][i];
+        return ans;
+    }
+
+    void PushBack(const SACMetaData &m){
+        gcarc.push_back(m.gcarc);
+        az.push_back(m.az);
+        evde.push_back(m.evde);
+        evlo.push_back(m.evlo);
+        evla.push_back(m.evla);
+        stlo.push_back(m.stlo);
+        stla.push_back(m.stla);
+        stnm.push_back(Intern(m.stnm));
+        network.push_back(Intern(m.network));
+        for (auto &item:tt) item.push_back(std::numeric_limits<double>::quiet_NaN());
+        ++n;
+        for (const auto &item:m.tt) Column(item.first)[n-1]=item.second;
+    }
+
+    void SetGcarc(const std::size_t &i, const double &v) {gcarc[i]=v;}
+    void SetAz(const std::size_t &i, const double &v) {az[i]=v;}
+
+    void ShiftTravelTimes(const std::size_t &i, const double &t){
+        for (auto &item:tt) item[i]-=t;
+    }
+
+    void Remove(const std::size_t &i){
+        if (i>=n)
+            throw std::runtime_error("SACMetaTable remove index out of range.");
+        ForEachColumn([&](auto &col){
+            std::swap(col[i],col.back());
+            col.pop_back();
+        });
+        --n;
+    }
+
+    void Reorder(const std::vector<std::size_t> &idx){
+        ForEachColumn([&](auto &col){ReorderUseIndex(col.begin(),col.end(),idx);});
+    }
+
+    SACMetaTable Select(const std::vector<std::size_t> &idx) const {
+        SACMetaTable ans=*this;
+        ans.ForEachColumn([&](auto &col){
+            auto old=col;
+            col.resize(idx.size());
+            for (std::size_t k=0;k<idx.size();++k) col[k]=old[idx[k]];
+        });
+        ans.n=idx.size();
+        return ans;
+    }
+};
+
+#endif
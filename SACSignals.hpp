@@ -1,8 +1,6 @@
 #ifndef ASU_SACSIGNALS
 #define ASU_SACSIGNALS
 
-#define MAXL 5000001
-
 #include<vector>
 #include<string>
 #include<cstring>
@@ -11,91 +9,161 @@
 #include<sstream>
 #include<set>
 #include<map>
+#include<memory>
 #include<cstdio>
-#include<fcntl.h>
-#include<unistd.h>
-
-extern "C"{
-#include<sacio.h>
-#include<sac.h>
-}
+#include<cmath>
+#include<tuple>
+#include<array>
+#include<algorithm>
+#include<unordered_map>
 
 #include<Lon2360.hpp>
 #include<GcpDistance.hpp>
 #include<FindAz.hpp>
 #include<SortWithIndex.hpp>
 #include<ReorderUseIndex.hpp>
+#include<CrossCorrelationEngine.hpp>
 #include<EvenSampledSignal.hpp>
+#include<ParallelFor.hpp>
+#include<LRUCache.hpp>
+#include<ReadSAC.hpp>
+#include<WriteSAC.hpp>
+#include<TraceMatrix.hpp>
+#include<SACHeader.hpp>
+#include<SACMetaData.hpp>
+#include<SACMetaTable.hpp>
+#include<SACArchive.hpp>
+#include<SignalPipeline.hpp>
 
 // Todos:
 // MetaData add event, depth, etc. header information.
-// Only read-in meta data for station selection.
-
-struct SACMetaData{
-    std::string stnm,network;
-    double gcarc,az,evde,evlo,evla,stlo,stla;
-    std::map<std::string,double> tt;           // all travel times avaliable in the sac file header.
-
-    SACMetaData () : SACMetaData("") {}
 
-    SACMetaData (const std::string &s) : SACMetaData(s,"") {}
+// Meta data only mode (headerOnly=true in the constructors):
+// Only SAC headers are read. Each record holds an empty EvenSampledSignal
+// which only knows its file name, delta and begin time.
+// Use metadata-based selections (CheckDist, CheckAz, CheckPhase, KeepRecords,
+// RemoveRecords, FindBy*, SortBy*, ShiftTime ...) to reduce the records,
+// then call LoadWaveforms() to read the waveforms of the survivors.
+//
+// Lazy mode (meta data only mode + SetCacheBudget):
+// Read-only members (GetSignal, GetWaveforms, CrossCorrelation, XCorrStack,
+// MakeNeatStack, SNR, DumpWaveforms, OutputToSAC ...) read the waveforms on
+// demand and keep them in a least-recently-used cache bounded by the given
+// byte budget. Members modifying the waveforms (Butterworth, HannTaper ...)
+// read each record the same way, modify it and keep it, i.e. the modified
+// records become normal in-memory records (outside of the cache budget).
+// GetData() reads all waveforms first (on a const object, it throws instead).
+// A waveform that can't be read always throws.
+//
+// Archive (see SACArchive.hpp):
+// WriteArchive() packs all records into one file. SACSignals(reader,indices)
+// reads only the selected records from the mapped archive; use
+// reader.MetaData(i) to decide which records to read.
+//
+// Data sets larger than memory: see StreamSACSignals.hpp.
+//
+// Subsets without copying: see SACSignalsView.hpp.
+//
+// Meta data (see SACMetaTable.hpp):
+// Meta data are stored in columns: one array per field, interned station and
+// network names, and one travel time column per phase (NaN if absent).
+// GetMetaTable() gives direct access to the columns; GetMData() builds a
+// SACMetaData for each record.
+//
+// Lookups:
+// FindByStnm, FindByNetwork and FindByGcarc use hash/sorted indices built on
+// the first call. The indices are updated by RemoveRecords (KeepRecords,
+// CheckDist, CheckAndCutToWindow ...), so records are never reordered for a
+// lookup. Results are in index order.
+//
+// Threads:
+// SetThreads(n) sets the number of threads used by the members which work on
+// each record independently (Butterworth, HannTaper, RemoveTrend, Interpolate,
+// CheckAndCutToWindow, CrossCorrelation, LoadWaveforms, WaterLevelDecon, SNR ...).
+// n=0: use all cores. Default is 1 (serial). Results don't depend on the number
+// of threads.
+// Only code that is safe to run concurrently may be called from these members:
+// Butterworth uses the native filter (ButterworthSOS.hpp), not libsac's
+// xapiir, which keeps global state and must never run on several threads;
+// FFTW planning goes through FFTWPlanCache.
+//
+// Pipeline (see SignalPipeline.hpp):
+// Apply(P) runs a chain of per-record steps (RemoveTrend, HannTaper,
+// Butterworth, CheckAndCutToWindow, NormalizeToPeak ...) on each record in one
+// pass. Result is the same as calling these members one after another.
+//
+// Sample type:
+// SACSignals stores double samples, FloatSACSignals stores float samples (SAC
+// files are float, so nothing is lost when loading, and memory is halved).
+// Stacks (MakeNeatStack, XCorrStack) are always accumulated and returned in double.
+
+template<typename T> class BasicSACSignalsView;
 
-    SACMetaData (const std::string &s, const std::string &n) : SACMetaData(s,n,0) {}
-
-    SACMetaData (const std::string &s, const std::string &n, const double &g) : SACMetaData(s,n,g,0) {}
-
-    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a) :
-                 SACMetaData(s,n,g,a,0,0,0,0,0) {}
-
-    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a,
-                 const double &ede, const double &elo, const double &ela, const double &slo, const double &sla) :
-                 SACMetaData(s,n,g,a,ede,elo,ela,slo,sla,std::map<std::string, double> ()) {}
-
-    SACMetaData (const std::string &s, const std::string &n, const double &g, const double &a,
-                 const double &ede, const double &elo, const double &ela, const double &slo, const double &sla,
-                 const std::map<std::string,double> &m) : stnm(s),network(n),gcarc(g),az(a),
-                                                          evde(ede), evlo(elo), evla(ela), stlo(slo), stla(sla), tt(m) {}
-};
-
-std::ostream &operator<<(std::ostream &os, const SACMetaData &item){
-    os << "Network: |" << item.network << "|\n";
-    os << "StationName: |" << item.stnm << "|\n";
-    os << "Az: |" << item.az << "|\n";
-    os << "Gcarc: |" << item.gcarc << "|\n";
-    os << "TravelTimes: " << '\n';
-    for (const auto &item2:item.tt)
-        os << "    " << item2.first << "  -  " << item2.second << " sec.\n";
-    return os;
-}
-
-class SACSignals {
+template<typename T>
+class BasicSACSignals {
 
 private:
-    std::vector<EvenSampledSignal> data;
-    std::vector<SACMetaData> mdata;
+    std::vector<BasicEvenSampledSignal<T>> data;
+    SACMetaTable mdata;
     std::string file_list_name,sorted_by;
+    std::size_t threads=1;                                          // see SetThreads.
+
+    // lookup indices for FindBy*: station/network name -> record indices, (gcarc,record index).
+    // Built on first use, kept up to date by RemoveRecords, dropped by members reordering the records.
+    bool indexed=false;
+    std::unordered_map<std::string,std::set<std::size_t>> stnm_index,network_index;
+    std::set<std::pair<double,std::size_t>> gcarc_index;
+    std::shared_ptr<LRUCache<std::string,std::vector<T>>> cache;   // samples of meta data only records.
+    bool loaded=true;                                               // false: there may be meta data only records.
+
+    void LoadSACFiles(const std::vector<std::string> &infiles, const std::size_t &nThreads=1,
+                      const bool &headerOnly=false);
+    const BasicEvenSampledSignal<T> &Trace(const std::size_t &index, BasicEvenSampledSignal<T> &buf) const;
+    std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
+        XCorrStack(const std::vector<std::size_t> &ind, const std::vector<double> &center_time,
+                   const double &t1, const double &t2, const int loopN) const;
+    EvenSampledSignal MakeNeatStack(const std::vector<std::size_t> &ind) const;
+    template<typename F> void ForEach(const F &f) const {ParallelFor(Size(),threads,f);}
+    void BuildIndices();
+    void IndexRecord(const std::size_t &i, const bool &add);
+    bool MetaDataOnly(const std::size_t &i) const {return data[i].Size()==0 && !data[i].GetFileName().empty();}
+    template<typename F> void Modify(const std::vector<std::size_t> &I, const std::size_t &B,
+                                     const std::size_t &nThreads, const F &f);
+    template<typename F> void Modify(const F &f);
 
 public:
 
     // Constructor/Destructors.
-    SACSignals ();
-    SACSignals (const SACSignals &item, const std::vector<std::size_t> &indices={});
-    SACSignals (const SACSignals &item, const std::set<std::size_t> &indices);
-    SACSignals (const std::vector<EvenSampledSignal> &signals, const std::vector<SACMetaData> &metadatas);
-    SACSignals (const std::string &infile);                 // a file contains path(s) to SAC file(s).
-    SACSignals (const std::vector<std::string> &infiles);   // a vector contains paths(s) to SAC file(s).
-    ~SACSignals () = default;
+    BasicSACSignals ();
+    BasicSACSignals (const BasicSACSignals &item, const std::vector<std::size_t> &indices={});
+    BasicSACSignals (const BasicSACSignals &item, const std::set<std::size_t> &indices);
+    BasicSACSignals (const std::vector<BasicEvenSampledSignal<T>> &signals, const std::vector<SACMetaData> &metadatas);
+    BasicSACSignals (const std::string &infile,                  // a file contains path(s) to SAC file(s).
+                const std::size_t &nThreads=1,              // nThreads=0: use all cores.
+                const bool &headerOnly=false);              // true: meta data only mode.
+    BasicSACSignals (const std::vector<std::string> &infiles,    // a vector contains paths(s) to SAC file(s).
+                const std::size_t &nThreads=1,
+                const bool &headerOnly=false);
+    BasicSACSignals (const SACArchive::Reader &archive,          // records in an archive.
+                const std::vector<std::size_t> &indices={}, // empty: all records.
+                const std::size_t &nThreads=1);
+    ~BasicSACSignals () = default;
 
     // Member function declarations.
-    void Clear() {*this=SACSignals();}
+    void Clear() {*this=BasicSACSignals();}
     double GetDelta() const {return (SameSamplingRate()?data[0].GetDelta():0);}
-    const std::vector<EvenSampledSignal> &GetData() const {return data;}
-    const std::vector<SACMetaData> &GetMData() const {return mdata;}
+    const std::vector<BasicEvenSampledSignal<T>> &GetData() const;
+    const std::vector<BasicEvenSampledSignal<T>> &GetData() {LoadWaveforms();return data;}
+    std::vector<SACMetaData> GetMData() const;
+    const SACMetaTable &GetMetaTable() const {return mdata;}
     std::size_t Size() const {return data.size();}
     std::string GetFileListName() const {return file_list_name;}
+    std::size_t GetThreads() const {return threads;}
+    void SetThreads(const std::size_t &n) {threads=n;}
 
-    void AddSignal(const EvenSampledSignal &s2, const std::vector<double> &dt={});
+    void AddSignal(const BasicEvenSampledSignal<T> &s2, const std::vector<double> &dt={});
     void AmplitudeDivision(const std::vector<double> &scales);
+    void Apply(const BasicSignalPipeline<T> &P);
     void Butterworth(const double &f1, const double &f2, const int &order=2, const int &passes=2);
     std::vector<double> BeginTime(const std::vector<std::size_t> &indices=std::vector<std::size_t> ()) const;
     void CheckAz(const double &d1=0, const double &d2=0);
@@ -104,40 +172,46 @@ public:
                     const double &t2=std::numeric_limits<double>::max());
     std::pair<std::vector<double>,std::vector<double>>
         CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
-                         const EvenSampledSignal &item, const double &h1, const double &h2,
+                         const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
                          const int &Flip=0, const std::pair<int,int> &ShiftLimit=
-                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}) const;
+                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                         const bool &SubSample=false) const;
     std::pair<std::vector<double>,std::vector<double>>
         CrossCorrelation(const double &t1, const double &t2,
-                         const EvenSampledSignal &item, const double &h1, const double &h2,
+                         const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
                          const int &Flip=0, const std::pair<int,int> &ShiftLimit=
-                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}) const;
+                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                         const bool &SubSample=false) const;
     std::pair<std::vector<double>,std::vector<double>>
         CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
-                         const std::vector<EvenSampledSignal> &items, const double &h1, const double &h2,
+                         const std::vector<BasicEvenSampledSignal<T>> &items, const double &h1, const double &h2,
                          const int &Flip=0, const std::pair<int,int> &ShiftLimit=
-                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}) const;
+                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                         const bool &SubSample=false) const;
     std::pair<std::vector<double>,std::vector<double>>
         CrossCorrelation(const double &t1, const double &t2,
-                         const std::vector<EvenSampledSignal> &items, const double &h1, const double &h2,
+                         const std::vector<BasicEvenSampledSignal<T>> &items, const double &h1, const double &h2,
                          const int &Flip=0, const std::pair<int,int> &ShiftLimit=
-                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()}) const;
+                         {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                         const bool &SubSample=false) const;
     void Diff();
     void DumpWaveforms(const std::string &dir=".", const std::string &namingConvention="",
-                       const std::string &prefix="", const std::string &seperator="_", const std::string &extension="txt") const;
+                       const std::string &prefix="", const std::string &seperator="_", const std::string &extension="txt",
+                       const std::size_t &nThreads=1) const;
     std::vector<double> EndTime(const std::vector<std::size_t> &indices=std::vector<std::size_t> ()) const;
     void FlipPeakDown();
     void FlipPeakUp();
     std::vector<std::size_t> FindByGcarc(const double &gc, const bool &bulk=false);
     std::vector<std::size_t> FindByStnm(const std::string &st, const bool &bulk=false);
     std::vector<std::size_t> FindByNetwork(const std::string &nt, const bool &bulk=false);
-    void GaussianBlur(const double &sigma=1);
+    void GaussianBlur(const double &sigma=1, const bool &Recursive=false);
     double GetDistance(const std::size_t &index=0) const;
     std::vector<double> GetDistances(const std::vector<std::size_t> &indices=std::vector<std::size_t> ()) const;
     std::vector<std::string> GetFileList() const;
     std::vector<std::string> GetNetworkNames() const;
     std::string GetNetworkName(const std::size_t &index) const;
     std::vector<std::string> GetSACFiles() const;
+    BasicEvenSampledSignal<T> GetSignal(const std::size_t &index) const;
     std::vector<std::string> GetStationNames() const;
     std::string GetStationName(const std::size_t &index) const;
     std::vector<double> GetTravelTimes(const std::string &phase,
@@ -150,6 +224,8 @@ public:
     void Integrate();
     void Interpolate(const double &dt);
     void KeepRecords(const std::vector<std::size_t> &indices);
+    void LoadWaveforms() {LoadWaveforms(threads);}
+    void LoadWaveforms(const std::size_t &nThreads);
     EvenSampledSignal MakeNeatStack() const;
     void Mask(const double &t1=-std::numeric_limits<double>::max(),
               const double &t2=std::numeric_limits<double>::max(),
@@ -160,7 +236,9 @@ public:
     void NormalizeToSignal();
     void OutputToSAC(const std::string &prefix="", const std::vector<std::size_t> &indices={},
                      const std::vector<std::map<std::string,double>> &F={},
-                     const std::vector<std::map<std::string,std::string>> &M={}) const;
+                     const std::vector<std::map<std::string,std::string>> &M={},
+                     const std::size_t &nThreads=1) const;
+    TraceMatrix<T> Pack(const std::vector<std::size_t> &indices={}) const;
     std::vector<double> PeakAmp(const std::vector<std::size_t> &indices=std::vector<std::size_t> ()) const;
     std::vector<double> PeakTime(const std::vector<std::size_t> &indices=std::vector<std::size_t> ()) const;
     void PrintInfo() const;
@@ -172,6 +250,7 @@ public:
     bool SameSamplingRate () const;
     bool SameSize () const;
     void SetBeginTime(const double &t);
+    void SetCacheBudget(const std::size_t &bytes);
     void SortByGcarc();
     void SortByNetwork();
     void SortByStnm();
@@ -179,78 +258,97 @@ public:
                             const double &st1, const double &st2,
                             const std::vector<double> &na=std::vector<double> (),
                             const std::vector<double> &sa=std::vector<double> ()) const;
-    void StretchToFit(const EvenSampledSignal &s, const double &t1, const double &t2,
+    std::vector<std::vector<double>> SNR(const std::vector<std::array<double,4>> &windows,
+                                         const std::vector<double> &na=std::vector<double> (),
+                                         const std::vector<double> &sa=std::vector<double> ()) const;
+    void StretchToFit(const BasicEvenSampledSignal<T> &s, const double &t1, const double &t2,
                       const double &h1, const double &h2, const double &ampLevel=0.25,
                       const bool &adaptive=false, const std::size_t method=0);
-    void StripSignal(const EvenSampledSignal &s2, const std::vector<double> &dt={});
-    void StripSignal(const std::vector<EvenSampledSignal> &s, const std::vector<double> &dt={});
-    void WaterLevelDecon(const EvenSampledSignal &s, const double &wl=0.1);
-    void WaterLevelDecon(SACSignals &D, const double &wl=0.1);
+    void StripSignal(const BasicEvenSampledSignal<T> &s2, const std::vector<double> &dt={});
+    void StripSignal(const std::vector<BasicEvenSampledSignal<T>> &s, const std::vector<double> &dt={});
+    void Unpack(const TraceMatrix<T> &M, const std::vector<std::size_t> &indices={});
+    void WaterLevelDecon(const BasicEvenSampledSignal<T> &s, const double &wl=0.1);
+    void WaterLevelDecon(BasicSACSignals &D, const double &wl=0.1);
+    void WriteArchive(const std::string &outfile) const;
+    void WriteArchive(SACArchive::Writer &W) const;
 
     // Member function template declarations.
-    template<typename T> void CheckAndCutToWindow(const std::vector<T> &center_time,
+    template<typename U> void CheckAndCutToWindow(const std::vector<U> &center_time,
                                                   const double &t1, const double &t2);
     void CheckAndCutToWindow(const double &t1, const double &t2);
-    template<typename T> void FindPeakAround(const std::vector<T> &center_time, const double &wl=5, const bool &positiveOnly=false);
+    template<typename U> void FindPeakAround(const std::vector<U> &center_time, const double &wl=5, const bool &positiveOnly=false);
     void FindPeakAround(const double &center_time, const double &wl=5, const bool &positiveOnly=false);
-    template<typename T> void FlipReverseSum(const std::vector<T> &t);
+    template<typename U> void FlipReverseSum(const std::vector<U> &t);
     void FlipReverseSum(const double &t);
-    template<typename T> void ShiftTime(const std::vector<T> &t);
-    template<typename T> void ShiftTime(const T &t);
+    template<typename U> void ShiftTime(const std::vector<U> &t);
+    template<typename U> void ShiftTime(const U &t);
     void ShiftTimeReferenceToPeak();
     std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
         XCorrStack(const double &center_time, const double &t1, const double &t2, const int loopN=5) const;
     std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
         XCorrStack(const std::vector<double> &center_time, const double &t1, const double &t2, const int loopN=5) const;
 
-    SACSignals &operator*=(const double &a){
-        for (std::size_t i=0;i<Size();++i) data[i]*=a;
+    BasicSACSignals &operator*=(const double &a){
+        Modify([&](const std::size_t &i){data[i]*=a;});
         return *this;
     }
 
-    SACSignals &operator/=(const double &a){
+    BasicSACSignals &operator/=(const double &a){
         if (a==0)
             throw std::runtime_error("Divided by zero ...");
         return *this*=1/a;
     }
 
-    SACSignals &operator-=(const EvenSampledSignal &item){
-        for (std::size_t i=0;i<Size();++i) data[i]-=item;
+    BasicSACSignals &operator-=(const BasicEvenSampledSignal<T> &item){
+        Modify([&](const std::size_t &i){data[i]-=item;});
         return *this;
     }
 
     // friends (non-member) declarations.
-    friend std::istream &operator>>(std::istream &is, SACSignals &item);
-    friend SACSignals operator*(const SACSignals &item,const double &a);
-    friend SACSignals operator-(const SACSignals &input,const EvenSampledSignal &item);
+    template<typename U> friend class BasicSACSignalsView;
+    template<typename U> friend std::istream &operator>>(std::istream &is, BasicSACSignals<U> &item);
+    template<typename U> friend BasicSACSignals<U> operator*(const BasicSACSignals<U> &item,const double &a);
+    template<typename U> friend BasicSACSignals<U> operator-(const BasicSACSignals<U> &input,const BasicEvenSampledSignal<U> &item);
 };
 
+typedef BasicSACSignals<double> SACSignals;
+typedef BasicSACSignals<float> FloatSACSignals;
+
 
 // Constructors/Destructors definition.
-SACSignals::SACSignals (){
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (){
     file_list_name="";
     sorted_by="None";
 }
 
-SACSignals::SACSignals (const SACSignals &item, const std::vector<std::size_t> &indices) {
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const BasicSACSignals<T> &item, const std::vector<std::size_t> &indices) {
     this->Clear();
     if (indices.empty()) *this=item;
     else {
+        std::vector<std::size_t> ind;
         for (std::size_t i=0; i<indices.size(); ++i) {
             if (indices[i]>=item.Size()) continue;
             this->data.push_back(item.data[indices[i]]);
-            this->mdata.push_back(item.mdata[indices[i]]);
+            ind.push_back(indices[i]);
         }
+        mdata=item.mdata.Select(ind);
+        cache=item.cache;
+        threads=item.threads;
+        loaded=item.loaded;
     }
     sorted_by="None";
 }
 
-SACSignals::SACSignals (const SACSignals &item, const std::set<std::size_t> &indices) {
-    *this=SACSignals(item, std::vector<size_t> (indices.begin(),indices.end()));
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const BasicSACSignals<T> &item, const std::set<std::size_t> &indices) {
+    *this=BasicSACSignals<T>(item, std::vector<size_t> (indices.begin(),indices.end()));
     sorted_by="None";
 }
 
-SACSignals::SACSignals (const std::vector<EvenSampledSignal> &signals, const std::vector<SACMetaData> &metadatas) {
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const std::vector<BasicEvenSampledSignal<T>> &signals, const std::vector<SACMetaData> &metadatas) {
 
     if (signals.size() != metadatas.size()) {
 
@@ -258,24 +356,47 @@ SACSignals::SACSignals (const std::vector<EvenSampledSignal> &signals, const std
     }
 
     data = signals;
-    mdata = metadatas;
+    for (const auto &item:metadatas) mdata.PushBack(item);
     file_list_name="None";
     sorted_by="None";
 }
 
-SACSignals::SACSignals (const std::string &infile){
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const std::string &infile, const std::size_t &nThreads, const bool &headerOnly){
     std::ifstream fpin(infile);
-    fpin >> *this;
+    std::vector<std::string> infiles;
+    std::string sacfilename;
+    while (fpin >> sacfilename) infiles.push_back(sacfilename);
     fpin.close();
+
+    LoadSACFiles(infiles,nThreads,headerOnly);
     file_list_name=infile;
     sorted_by="None";
 }
 
-SACSignals::SACSignals (const std::vector<std::string> &infiles){
-    std::stringstream ss;
-    std::copy(infiles.begin(),infiles.end(),std::ostream_iterator<std::string>(ss,"\n"));
-    ss >> *this;
-    ss.str(std::string());
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const std::vector<std::string> &infiles, const std::size_t &nThreads, const bool &headerOnly){
+    LoadSACFiles(infiles,nThreads,headerOnly);
+    file_list_name="None";
+    sorted_by="None";
+}
+
+template<typename T>
+BasicSACSignals<T>::BasicSACSignals (const SACArchive::Reader &archive, const std::vector<std::size_t> &indices,
+                        const std::size_t &nThreads){
+
+    std::vector<std::size_t> I=indices;
+    if (I.empty())
+        for (std::size_t i=0;i<archive.Size();++i) I.push_back(i);
+
+    data.resize(I.size());
+    std::vector<SACMetaData> M(I.size());
+    ParallelFor(I.size(),nThreads,[&](const std::size_t &i){
+        data[i]=BasicEvenSampledSignal<T>(archive.Signal(I[i]));
+        M[i]=archive.MetaData(I[i]);
+    });
+    for (const auto &item:M) mdata.PushBack(item);
+
     file_list_name="None";
     sorted_by="None";
 }
@@ -283,35 +404,162 @@ SACSignals::SACSignals (const std::vector<std::string> &infiles){
 
 // Member function definitions.
 
-void SACSignals::AddSignal(const EvenSampledSignal &s2, const std::vector<double> &dt){
+// Read SAC files, records keep the input order.
+// Unreadable or unevenly sampled records are ignored.
+// If headerOnly is true, only the headers are read (see LoadWaveforms).
+template<typename T>
+void BasicSACSignals<T>::LoadSACFiles(const std::vector<std::string> &infiles, const std::size_t &nThreads,
+                              const bool &headerOnly){
+
+    std::size_t n=infiles.size();
+    std::vector<BasicEvenSampledSignal<T>> D(n);
+    std::vector<SACMetaData> M(n);
+    std::vector<char> good(n,0);
+
+    ParallelFor(n,nThreads,[&](const std::size_t &i){
+
+        // we only pull these headers:
+        // network code, station code, gcarc, traveltimes,
+        // event lon/lat, station lon/lat.
+        SACHeader hdr;
+        std::vector<T> amp;
+        if (headerOnly ? !ReadSAC(infiles[i],hdr) : !ReadSAC(infiles[i],hdr,amp)) return;
+
+        D[i]=BasicEvenSampledSignal<T>(std::move(amp),hdr.GetFloat("delta"),hdr.GetFloat("b"),infiles[i]);
+        M[i]=SACMetaData(hdr);
+        good[i]=1;
+    });
+
+    data.clear();
+    mdata.Clear();
+    indexed=false;
+    loaded=!headerOnly;
+    for (std::size_t i=0;i<n;++i) {
+        if (!good[i]) continue;
+        data.push_back(std::move(D[i]));
+        mdata.PushBack(M[i]);
+    }
+}
+
+// Return the record; for meta data only records, read the samples into buf
+// (through the cache, if there is one) and return buf.
+template<typename T>
+const BasicEvenSampledSignal<T> &BasicSACSignals<T>::Trace(const std::size_t &index, BasicEvenSampledSignal<T> &buf) const {
+
+    const auto &item=data[index];
+    if (item.Size()!=0 || item.GetFileName().empty()) return item;
+
+    std::vector<T> amp;
+    if (!cache || !cache->Get(item.GetFileName(),amp)) {
+        SACHeader hdr;
+        if (!ReadSAC(item.GetFileName(),hdr,amp))
+            throw std::runtime_error("Can't read waveform from "+item.GetFileName()+" ...");
+        if (cache) cache->Put(item.GetFileName(),amp);
+    }
+    buf=BasicEvenSampledSignal<T>(std::move(amp),item.GetDelta(),item.BeginTime(),item.GetFileName());
+    return buf;
+}
+
+template<typename T>
+void BasicSACSignals<T>::BuildIndices(){
+    stnm_index.clear();
+    network_index.clear();
+    gcarc_index.clear();
+    for (std::size_t i=0;i<Size();++i) IndexRecord(i,true);
+    indexed=true;
+}
+
+// Add record i to (or remove it from) the lookup indices.
+template<typename T>
+void BasicSACSignals<T>::IndexRecord(const std::size_t &i, const bool &add){
+    auto update=[&](std::unordered_map<std::string,std::set<std::size_t>> &index, const std::string &key){
+        if (add) index[key].insert(i);
+        else {
+            auto it=index.find(key);
+            if (it==index.end()) return;
+            it->second.erase(i);
+            if (it->second.empty()) index.erase(it);
+        }
+    };
+    update(stnm_index,mdata.Stnm(i));
+    update(network_index,mdata.Network(i));
+
+    double gcarc=mdata.Gcarc()[i];
+    if (std::isnan(gcarc)) return;
+    if (add) gcarc_index.insert({gcarc,i});
+    else gcarc_index.erase({gcarc,i});
+}
+
+template<typename T>
+void BasicSACSignals<T>::AddSignal(const BasicEvenSampledSignal<T> &s2, const std::vector<double> &dt){
 
     if (!dt.empty() && Size()!=dt.size())
         throw std::runtime_error("Add signal time shift have different size.");
 
     if (dt.empty())
-        for (std::size_t i=0;i<Size();++i)
-            data[i].AddSignal(s2);
+        Modify([&](const std::size_t &i){data[i].AddSignal(s2);});
     else
-        for (std::size_t i=0;i<Size();++i)
-            data[i].AddSignal(s2,dt[i]);
+        Modify([&](const std::size_t &i){data[i].AddSignal(s2,dt[i]);});
     return;
 }
 
-void SACSignals::AmplitudeDivision(const std::vector<double> &scales){
+template<typename T>
+void BasicSACSignals<T>::AmplitudeDivision(const std::vector<double> &scales){
     if (scales.size()!=Size())
         throw std::runtime_error("Scales size doesn't match.");
 
-    for (std::size_t i=0;i<Size();++i)
-        data[i]/=scales[i];
+    Modify([&](const std::size_t &i){data[i]/=scales[i];});
+}
+
+// Run the chain on each record, then remove the dropped records in the order
+// the separate CheckAndCutToWindow calls would have removed them.
+template<typename T>
+void BasicSACSignals<T>::Apply(const BasicSignalPipeline<T> &P){
+    if (!P.Check(Size()))
+        throw std::runtime_error("Pipeline step array size doesn't match.");
+
+    std::vector<std::size_t> dropped(Size());
+    Modify([&](const std::size_t &i){dropped[i]=P.Run(data[i],i);});
+
+    std::vector<std::size_t> orig(Size());  // original index of the current records.
+    for (std::size_t i=0;i<Size();++i) orig[i]=i;
+    for (std::size_t k=0;k<P.Size();++k) {
+        std::vector<std::size_t> BadIndices;
+        for (std::size_t j=0;j<orig.size();++j)
+            if (dropped[orig[j]]==k) BadIndices.push_back(j);
+        if (BadIndices.empty()) continue;
+        RemoveRecords(BadIndices);
+        std::sort(BadIndices.begin(),BadIndices.end(),std::greater<std::size_t>());
+        for (const auto &j:BadIndices) {
+            std::swap(orig[j],orig.back());
+            orig.pop_back();
+        }
+    }
 }
 
-void SACSignals::Butterworth(const double &f1, const double &f2,
+template<typename T>
+void BasicSACSignals<T>::Butterworth(const double &f1, const double &f2,
                              const int &order, const int &passes){
-    for (std::size_t i=0;i<Size();++i)
-        data[i].Butterworth(f1,f2,order,passes);
+
+    // records with the same delta and size are filtered together, several
+    // per SIMD register (see ButterworthBatch.hpp). Sort them into blocks
+    // (the size of meta data only records is not known yet, they are sorted
+    // by delta; the batch filter groups them by size).
+    std::vector<std::size_t> I(Size());
+    for (std::size_t i=0;i<Size();++i) I[i]=i;
+    std::sort(I.begin(),I.end(),[&](const std::size_t &a, const std::size_t &b){
+        return std::make_pair(data[a].GetDelta(),data[a].Size())<std::make_pair(data[b].GetDelta(),data[b].Size());
+    });
+
+    Modify(I,64,threads,[&](const std::vector<std::size_t> &J){
+        std::vector<BasicEvenSampledSignal<T> *> S;
+        for (const auto &i:J) S.push_back(&data[i]);
+        BasicEvenSampledSignal<T>::Butterworth(S,f1,f2,order,passes);
+    });
 }
 
-std::vector<double> SACSignals::BeginTime(const std::vector<std::size_t> &indices) const {
+template<typename T>
+std::vector<double> BasicSACSignals<T>::BeginTime(const std::vector<std::size_t> &indices) const {
     std::vector<double> ans;
     if (indices.empty())
         for (std::size_t i=0;i<Size();++i) ans.push_back(data[i].BeginTime());
@@ -323,296 +571,298 @@ std::vector<double> SACSignals::BeginTime(const std::vector<std::size_t> &indice
     return ans;
 }
 
-void SACSignals::CheckAz(const double &d1, const double &d2){
+template<typename T>
+void BasicSACSignals<T>::CheckAz(const double &d1, const double &d2){
     if (d1==d2) return;
 
     double lowerBound=Lon2360(d1), upperBound=Lon2360(d2);
 
+    const auto &az=mdata.Az();
     std::vector<std::size_t> BadIndices;
     if (lowerBound>upperBound) {
         for (std::size_t i=0;i<Size();++i)
-            if (Lon2360(mdata[i].az)<lowerBound && Lon2360(mdata[i].az)>upperBound) BadIndices.push_back(i);
+            if (Lon2360(az[i])<lowerBound && Lon2360(az[i])>upperBound) BadIndices.push_back(i);
     }
     else {
         for (std::size_t i=0;i<Size();++i)
-            if (Lon2360(mdata[i].az)<lowerBound || Lon2360(mdata[i].az)>upperBound) BadIndices.push_back(i);
+            if (Lon2360(az[i])<lowerBound || Lon2360(az[i])>upperBound) BadIndices.push_back(i);
     }
     RemoveRecords(BadIndices);
 }
 
-void SACSignals::CheckDist(const double &d1, const double &d2){
+template<typename T>
+void BasicSACSignals<T>::CheckDist(const double &d1, const double &d2){
+    const auto &gcarc=mdata.Gcarc();
     std::vector<std::size_t> BadIndices;
     for (std::size_t i=0;i<Size();++i)
-        if (mdata[i].gcarc<d1 || mdata[i].gcarc>d2) BadIndices.push_back(i);
+        if (gcarc[i]<d1 || gcarc[i]>d2) BadIndices.push_back(i);
     RemoveRecords(BadIndices);
 }
 
-void SACSignals::CheckPhase(const std::string &phase, const double &t1, const double &t2){
+template<typename T>
+void BasicSACSignals<T>::CheckPhase(const std::string &phase, const double &t1, const double &t2){
+    const std::vector<double> *tt=mdata.Phase(phase);
     std::vector<std::size_t> BadIndices;
-    for (std::size_t i=0;i<Size();++i) {
-        auto it=mdata[i].tt.find(phase);
-        if (it==mdata[i].tt.end() || it->second<t1 || it->second>t2 )
+    for (std::size_t i=0;i<Size();++i)
+        if (tt==nullptr || std::isnan((*tt)[i]) || (*tt)[i]<t1 || (*tt)[i]>t2)
             BadIndices.push_back(i);
-    }
     RemoveRecords(BadIndices);
 }
 
 // negative shift time: item is shifting forward.
+template<typename T>
 std::pair<std::vector<double>,std::vector<double>>
-SACSignals::CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
-                             const EvenSampledSignal &item, const double &h1, const double &h2,
-                             const int &Flip, const std::pair<int,int> &ShiftLimit) const {
+BasicSACSignals<T>::CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
+                             const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
+                             const int &Flip, const std::pair<int,int> &ShiftLimit,
+                             const bool &SubSample) const {
     std::pair<std::vector<double>,std::vector<double>> ans;
-    for (std::size_t i=0;i<Size();++i) {
-        auto res=data[i].CrossCorrelation(t1[i],t2[i],item,h1,h2,Flip,ShiftLimit);
-        ans.first.push_back(res.first);
-        ans.second.push_back(res.second);
+    ans.first.resize(Size());
+    ans.second.resize(Size());
+    if (!item.CheckWindow(h1,h2)) {
+        std::cerr << "CrossCorrelation window on signal 2 is not proper." << std::endl;
+        return ans;
     }
+
+    // prepare the template once for all records.
+    CrossCorrelationEngine E(item.GetAmp().begin()+item.LocateTime(h1),
+                             item.GetAmp().begin()+item.LocateTime(h2)+1,Flip,ShiftLimit);
+    ForEach([&](const std::size_t &i){
+        BasicEvenSampledSignal<T> buf;
+        std::tie(ans.first[i],ans.second[i])=Trace(i,buf).CrossCorrelation(t1[i],t2[i],E,SubSample);
+    });
     return ans;
 }
+template<typename T>
 std::pair<std::vector<double>,std::vector<double>>
-SACSignals::CrossCorrelation(const double &t1, const double &t2,
-                             const EvenSampledSignal &item, const double &h1, const double &h2,
-                             const int &Flip, const std::pair<int,int> &ShiftLimit) const {
-    return CrossCorrelation(std::vector<double> (Size(),t1),std::vector<double> (Size(),t2),item,h1,h2,Flip,ShiftLimit);
+BasicSACSignals<T>::CrossCorrelation(const double &t1, const double &t2,
+                             const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
+                             const int &Flip, const std::pair<int,int> &ShiftLimit,
+                             const bool &SubSample) const {
+    return CrossCorrelation(std::vector<double> (Size(),t1),std::vector<double> (Size(),t2),item,h1,h2,Flip,ShiftLimit,SubSample);
 }
+template<typename T>
 std::pair<std::vector<double>,std::vector<double>>
-SACSignals::CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
-                             const std::vector<EvenSampledSignal> &items, const double &h1, const double &h2,
-                             const int &Flip, const std::pair<int,int> &ShiftLimit) const {
+BasicSACSignals<T>::CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
+                             const std::vector<BasicEvenSampledSignal<T>> &items, const double &h1, const double &h2,
+                             const int &Flip, const std::pair<int,int> &ShiftLimit,
+                             const bool &SubSample) const {
     if (Size()!=items.size())
         throw std::runtime_error("In CrossCorrelation, signal size doesn't match ...");
     std::pair<std::vector<double>,std::vector<double>> ans;
-    for (std::size_t i=0;i<Size();++i) {
-        auto res=data[i].CrossCorrelation(t1[i],t2[i],items[i],h1,h2,Flip,ShiftLimit);
-        ans.first.push_back(res.first);
-        ans.second.push_back(res.second);
-    }
+    ans.first.resize(Size());
+    ans.second.resize(Size());
+    ForEach([&](const std::size_t &i){
+        BasicEvenSampledSignal<T> buf;
+        std::tie(ans.first[i],ans.second[i])=Trace(i,buf).CrossCorrelation(t1[i],t2[i],items[i],h1,h2,Flip,ShiftLimit,SubSample);
+    });
     return ans;
 }
 
+template<typename T>
 std::pair<std::vector<double>,std::vector<double>>
-SACSignals::CrossCorrelation(const double &t1, const double &t2,
-                             const std::vector<EvenSampledSignal> &items, const double &h1, const double &h2,
-                             const int &Flip, const std::pair<int,int> &ShiftLimit) const {
+BasicSACSignals<T>::CrossCorrelation(const double &t1, const double &t2,
+                             const std::vector<BasicEvenSampledSignal<T>> &items, const double &h1, const double &h2,
+                             const int &Flip, const std::pair<int,int> &ShiftLimit,
+                             const bool &SubSample) const {
 
     if (Size()!=items.size())
         throw std::runtime_error("In CrossCorrelation, signal size doesn't match ...");
-    return CrossCorrelation(std::vector<double> (Size(),t1),std::vector<double> (Size(),t2),items,h1,h2,Flip,ShiftLimit);
+    return CrossCorrelation(std::vector<double> (Size(),t1),std::vector<double> (Size(),t2),items,h1,h2,Flip,ShiftLimit,SubSample);
 }
 
-void SACSignals::Diff() {
-    for (std::size_t i=0;i<Size();++i)
-        data[i].Diff();
+template<typename T>
+void BasicSACSignals<T>::Diff() {
+    Modify([&](const std::size_t &i){data[i].Diff();});
 }
 
-void SACSignals::DumpWaveforms(const std::string &dir, const std::string &namingConvention,
-                               const std::string &prefix, const std::string &seperator, const std::string &extension) const{
+template<typename T>
+void BasicSACSignals<T>::DumpWaveforms(const std::string &dir, const std::string &namingConvention,
+                               const std::string &prefix, const std::string &seperator, const std::string &extension,
+                               const std::size_t &nThreads) const{
     if (seperator.find("/")!=std::string::npos)
         throw std::runtime_error("In DumpWaveforms, seperator has sub directory.");
 
     std::string c=(dir.back()=='/'?"":"/");
+    std::vector<std::string> outfiles(Size());
     if (namingConvention=="StationName") {
         auto stationNames=GetStationNames();
-        for (std::size_t i=0;i<Size();++i){
-            std::ofstream fpout(dir+c+prefix+seperator+stationNames[i]+"."+extension);
-            fpout << GetData()[i];
-            fpout.close();
-        }
+        for (std::size_t i=0;i<Size();++i)
+            outfiles[i]=dir+c+prefix+seperator+stationNames[i]+"."+extension;
     }
     else {
         for (std::size_t i=0;i<Size();++i){
-
-            auto s=GetData()[i].GetFileName();
+            auto s=data[i].GetFileName();
             s=s.substr(s.find_last_of('/')+1);
-
-            std::ofstream fpout(dir+c+s+".txt");
-            fpout << GetData()[i];
-            fpout.close();
+            outfiles[i]=dir+c+s+".txt";
         }
     }
+
+    // format in memory, then write each file at once.
+    ParallelFor(Size(),nThreads,[&](const std::size_t &i){
+        BasicEvenSampledSignal<T> buf;
+        std::ostringstream ss;
+        ss << Trace(i,buf);
+        std::string content=ss.str();
+
+        std::ofstream fpout(outfiles[i],std::ios::binary);
+        fpout.write(content.data(),content.size());
+        fpout.close();
+    });
 }
 
-std::vector<double> SACSignals::EndTime(const std::vector<std::size_t> &indices) const {
+template<typename T>
+std::vector<double> BasicSACSignals<T>::EndTime(const std::vector<std::size_t> &indices) const {
     std::vector<double> ans;
+    BasicEvenSampledSignal<T> buf;
     if (indices.empty())
-        for (std::size_t i=0;i<Size();++i) ans.push_back(data[i].EndTime());
+        for (std::size_t i=0;i<Size();++i) ans.push_back(Trace(i,buf).EndTime());
     else
         for (const auto &i:indices) {
             if (i>=Size()) continue;
-            ans.push_back(data[i].EndTime());
+            ans.push_back(Trace(i,buf).EndTime());
         }
     return ans;
 }
 
-void SACSignals::FlipPeakDown() {
-    for (std::size_t i=0;i<Size();++i)
-        data[i].FlipPeakUp();
+template<typename T>
+void BasicSACSignals<T>::FlipPeakDown() {
+    Modify([&](const std::size_t &i){data[i].FlipPeakUp();});
     (*this)*=-1;
 }
 
-void SACSignals::FlipPeakUp() {
-    for (std::size_t i=0;i<Size();++i)
-        data[i].FlipPeakUp();
+template<typename T>
+void BasicSACSignals<T>::FlipPeakUp() {
+    Modify([&](const std::size_t &i){data[i].FlipPeakUp();});
 }
 
-std::vector<std::size_t> SACSignals::FindByGcarc(const double &gc, const bool &bulk) {
+// Records with the closest gcarc (all of them if there's a tie), in index order.
+// bulk: not used anymore (lookups use the indices), kept for compatibility.
+template<typename T>
+std::vector<std::size_t> BasicSACSignals<T>::FindByGcarc(const double &gc, const bool &/*bulk*/) {
+    if (!indexed) BuildIndices();
     std::vector<std::size_t> ans;
-    if (sorted_by=="Gcarc") {
-
-        if (Size()==1) {
-            ans.push_back(0);
-            return ans;
-        }
-
-        auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){
-            return m1.gcarc<m2.gcarc;
-        };
-        SACMetaData dummy("","",gc);
-        auto it1=std::lower_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        auto it2=std::upper_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        if (it1==it2) {
-            if (it1==mdata.end()) ans.push_back(std::distance(mdata.begin(),std::prev(it1)));
-            else if (it1==mdata.begin()) ans.push_back(0);
-            else {
-                if (fabs(it1->gcarc-gc)<fabs(std::prev(it1)->gcarc-gc))
-                    ans.push_back(std::distance(mdata.begin(),it1));
-                else
-                    ans.push_back(std::distance(mdata.begin(),std::prev(it1)));
-            }
-        }
-        else {
-            for (auto it=it1;it!=it2;++it)
-                ans.push_back(std::distance(mdata.begin(),it));
-        }
-        return ans;
-    }
-
-    if (bulk) {
-        SortByGcarc();
-        return FindByGcarc(gc);
+    if (gcarc_index.empty()) return ans;
+
+    auto it=gcarc_index.lower_bound({gc,0});
+    double d1=std::numeric_limits<double>::max(),d2=d1;
+    if (it!=gcarc_index.begin()) d1=fabs(std::prev(it)->first-gc);
+    if (it!=gcarc_index.end()) d2=fabs(it->first-gc);
+    double MinDiff=std::min(d1,d2);
+
+    if (d1==MinDiff) {
+        double g=std::prev(it)->first;
+        for (auto it2=gcarc_index.lower_bound({g,0});it2!=it;++it2)
+            ans.push_back(it2->second);
     }
-
-    double MinDiff=std::numeric_limits<double>::max();
-    for (std::size_t i=0;i<Size();++i) {
-        double diff=fabs(mdata[i].gcarc-gc);
-        if (MinDiff>diff) {
-            ans.clear();
-            MinDiff=diff;
-            ans.push_back(i);
-        }
-        else if (MinDiff==diff) ans.push_back(i);
+    if (d2==MinDiff) {
+        double g=it->first;
+        for (auto it2=it;it2!=gcarc_index.end() && it2->first==g;++it2)
+            ans.push_back(it2->second);
     }
+    std::sort(ans.begin(),ans.end());
     return ans;
 }
 
-std::vector<std::size_t> SACSignals::FindByNetwork(const std::string &nt, const bool &bulk) {
-    std::vector<std::size_t> ans;
-    if (sorted_by=="Network") {
-        auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){
-            return m1.network<m2.network;
-        };
-        SACMetaData dummy("",nt);
-        auto it1=std::lower_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        auto it2=std::upper_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        for (auto it=it1;it!=it2;++it)
-            ans.push_back(std::distance(mdata.begin(),it));
-        return ans;
-    }
-
-    if (bulk) {
-        SortByNetwork();
-        return FindByNetwork(nt);
-    }
-
-    for (std::size_t i=0;i<Size();++i)
-        if (mdata[i].network==nt)
-            ans.push_back(i);
-    return ans;
+template<typename T>
+std::vector<std::size_t> BasicSACSignals<T>::FindByNetwork(const std::string &nt, const bool &/*bulk*/) {
+    if (!indexed) BuildIndices();
+    auto it=network_index.find(nt);
+    if (it==network_index.end()) return {};
+    return std::vector<std::size_t> (it->second.begin(),it->second.end());
 }
 
-std::vector<std::size_t> SACSignals::FindByStnm(const std::string &st, const bool &bulk) {
-    std::vector<std::size_t> ans;
-    if (sorted_by=="Stnm") {
-        auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){
-            return m1.stnm<m2.stnm;
-        };
-        SACMetaData dummy(st);
-        auto it1=std::lower_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        auto it2=std::upper_bound(mdata.begin(),mdata.end(),dummy,cmp);
-        for (auto it=it1;it!=it2;++it)
-            ans.push_back(std::distance(mdata.begin(),it));
-        return ans;
-    }
-
-    if (bulk) {
-        SortByStnm();
-        return FindByStnm(st);
-    }
-
-    for (std::size_t i=0;i<Size();++i)
-        if (mdata[i].stnm==st)
-            ans.push_back(i);
-    return ans;
+template<typename T>
+std::vector<std::size_t> BasicSACSignals<T>::FindByStnm(const std::string &st, const bool &/*bulk*/) {
+    if (!indexed) BuildIndices();
+    auto it=stnm_index.find(st);
+    if (it==stnm_index.end()) return {};
+    return std::vector<std::size_t> (it->second.begin(),it->second.end());
 }
 
-void SACSignals::GaussianBlur(const double &sigma){
-    for (std::size_t i=0;i<Size();++i)
-        data[i].GaussianBlur(sigma);
+template<typename T>
+void BasicSACSignals<T>::GaussianBlur(const double &sigma, const bool &Recursive){
+    Modify([&](const std::size_t &i){data[i].GaussianBlur(sigma,Recursive);});
 }
 
-double SACSignals::GetDistance(const std::size_t &index) const {
+template<typename T>
+double BasicSACSignals<T>::GetDistance(const std::size_t &index) const {
     if (index>=Size()) return 0.0/0.0;
-    return mdata[index].gcarc;
+    return mdata.Gcarc()[index];
 }
 
-std::vector<double> SACSignals::GetDistances(const std::vector<std::size_t> &indices) const{
+template<typename T>
+std::vector<double> BasicSACSignals<T>::GetDistances(const std::vector<std::size_t> &indices) const{
     std::vector<double> ans;
     if (indices.empty())
-        for (const auto &item:mdata)
-            ans.push_back(item.gcarc);
+        ans=mdata.Gcarc();
     else {
         for (const auto &i:indices) {
             if (i>=Size()) continue;
-            ans.push_back(mdata[i].gcarc);
+            ans.push_back(mdata.Gcarc()[i]);
         }
     }
     return ans;
 }
 
-std::vector<std::string> SACSignals::GetFileList() const{
+template<typename T>
+std::vector<std::string> BasicSACSignals<T>::GetFileList() const{
     std::vector<std::string> ans;
     for (const auto &item:data)
         ans.push_back(item.GetFileName());
     return ans;
 }
 
-std::vector<std::string> SACSignals::GetNetworkNames() const{
+// Return a copy of the record. (read from file for meta data only records)
+template<typename T>
+BasicEvenSampledSignal<T> BasicSACSignals<T>::GetSignal(const std::size_t &index) const {
+    if (index>=Size())
+        throw std::runtime_error("GetSignal index out of range.");
+    BasicEvenSampledSignal<T> buf;
+    const auto &item=Trace(index,buf);
+    if (&item==&buf) return buf;
+    return item;
+}
+
+template<typename T>
+std::vector<SACMetaData> BasicSACSignals<T>::GetMData() const{
+    std::vector<SACMetaData> ans;
+    for (std::size_t i=0;i<Size();++i)
+        ans.push_back(mdata.Get(i));
+    return ans;
+}
+
+template<typename T>
+std::vector<std::string> BasicSACSignals<T>::GetNetworkNames() const{
     std::vector<std::string> ans;
-    for (const auto &item:mdata)
-        ans.push_back(item.network);
+    for (std::size_t i=0;i<Size();++i)
+        ans.push_back(mdata.Network(i));
     return ans;
 }
 
-std::string SACSignals::GetNetworkName(const std::size_t &index) const{
-    if (index>Size()) return "";
-    return mdata[index].network;
+template<typename T>
+std::string BasicSACSignals<T>::GetNetworkName(const std::size_t &index) const{
+    if (index>=Size()) return "";
+    return mdata.Network(index);
 }
 
-std::vector<std::string> SACSignals::GetStationNames() const{
+template<typename T>
+std::vector<std::string> BasicSACSignals<T>::GetStationNames() const{
     std::vector<std::string> ans;
-    for (const auto &item:mdata)
-        ans.push_back(item.stnm);
+    for (std::size_t i=0;i<Size();++i)
+        ans.push_back(mdata.Stnm(i));
     return ans;
 }
 
-std::string SACSignals::GetStationName(const std::size_t &index) const{
-    if (index>Size()) return "";
-    return mdata[index].stnm;
+template<typename T>
+std::string BasicSACSignals<T>::GetStationName(const std::size_t &index) const{
+    if (index>=Size()) return "";
+    return mdata.Stnm(index);
 }
 
 
-std::vector<double> SACSignals::GetTravelTimes(const std::string &phase,
+template<typename T>
+std::vector<double> BasicSACSignals<T>::GetTravelTimes(const std::string &phase,
                                                const std::vector<std::size_t> &indices) const {
 
     // Notice: if phase = "S" or "P", this will also return Sdiff and Pdiff travel times.
@@ -620,72 +870,80 @@ std::vector<double> SACSignals::GetTravelTimes(const std::string &phase,
     if (phase=="S") phase2="Sdiff";
     if (phase=="P") phase2="Pdiff";
 
+    const std::vector<double> *tt=mdata.Phase(phase), *tt2=mdata.Phase(phase2);
+    auto get=[&](const std::size_t &i){
+        if (tt!=nullptr && !std::isnan((*tt)[i])) return (*tt)[i];
+        if (tt2!=nullptr && !std::isnan((*tt2)[i])) return (*tt2)[i];
+        return -1.0;
+    };
+
     std::vector<double> ans;
     if (indices.empty())
-        for (const auto &item:mdata) {
-            auto it=item.tt.find(phase), it2=item.tt.find(phase2);
-            if (it!=item.tt.end()) ans.push_back(it->second);
-            else if (it2!=item.tt.end()) ans.push_back(it2->second);
-            else ans.push_back(-1);
-        }
+        for (std::size_t i=0;i<Size();++i) ans.push_back(get(i));
     else
         for (const auto &i:indices){
             if (i>=Size()) continue;
-            auto it=mdata[i].tt.find(phase), it2=mdata[i].tt.find(phase2);
-            if (it!=mdata[i].tt.end()) ans.push_back(it->second);
-            else if (it2!=mdata[i].tt.end()) ans.push_back(it2->second);
-            else ans.push_back(-1);
+            ans.push_back(get(i));
         }
     return ans;
 }
 
 
+template<typename T>
 std::vector<std::pair<std::vector<double>,std::vector<double>>>
-SACSignals::GetTimeAndWaveforms(const std::vector<std::size_t> &indices) const {
+BasicSACSignals<T>::GetTimeAndWaveforms(const std::vector<std::size_t> &indices) const {
     std::vector<std::pair<std::vector<double>,std::vector<double>>> ans;
+    BasicEvenSampledSignal<T> buf;
     if (indices.empty())
-        for (std::size_t i=0;i<Size();++i)
-            ans.push_back({data[i].GetTime(),data[i].GetAmp()});
+        for (std::size_t i=0;i<Size();++i) {
+            const auto &item=Trace(i,buf);
+            ans.push_back({item.GetTime(),std::vector<double> (item.GetAmp().begin(),item.GetAmp().end())});
+        }
     else
         for (const auto &i:indices) {
             if (i>=Size()) continue;
-            ans.push_back({data[i].GetTime(),data[i].GetAmp()});
+            const auto &item=Trace(i,buf);
+            ans.push_back({item.GetTime(),std::vector<double> (item.GetAmp().begin(),item.GetAmp().end())});
         }
     return ans;
 }
 
+template<typename T>
 std::vector<std::vector<double>>
-SACSignals::GetWaveforms(const std::vector<std::size_t> &indices) const {
+BasicSACSignals<T>::GetWaveforms(const std::vector<std::size_t> &indices) const {
     std::vector<std::vector<double>> ans;
+    BasicEvenSampledSignal<T> buf;
     if (indices.empty())
-        for (std::size_t i=0;i<Size();++i)
-            ans.push_back(data[i].GetAmp());
+        for (std::size_t i=0;i<Size();++i) {
+            const auto &amp=Trace(i,buf).GetAmp();
+            ans.push_back(std::vector<double> (amp.begin(),amp.end()));
+        }
     else
         for (const auto &i:indices) {
             if (i>=Size()) continue;
-            ans.push_back(data[i].GetAmp());
+            const auto &amp=Trace(i,buf).GetAmp();
+            ans.push_back(std::vector<double> (amp.begin(),amp.end()));
         }
     return ans;
 }
 
-void SACSignals::HannTaper(const double &wl) {
-    for (std::size_t i=0;i<Size();++i)
-        data[i].HannTaper(wl);
+template<typename T>
+void BasicSACSignals<T>::HannTaper(const double &wl) {
+    Modify([&](const std::size_t &i){data[i].HannTaper(wl);});
 }
 
-void SACSignals::Integrate() {
-    for (std::size_t i=0;i<Size();++i)
-        data[i].Integrate();
+template<typename T>
+void BasicSACSignals<T>::Integrate() {
+    Modify([&](const std::size_t &i){data[i].Integrate();});
 }
 
-void SACSignals::Interpolate(const double &dt) {
-    std::vector<EvenSampledSignal> old_data;
-    std::swap(data,old_data);
-    for (const EvenSampledSignal &item:old_data)
-        data.push_back(EvenSampledSignal(item,dt));
+template<typename T>
+void BasicSACSignals<T>::Interpolate(const double &dt) {
+    Modify([&](const std::size_t &i){data[i]=BasicEvenSampledSignal<T>(data[i],dt);});
 }
 
-void SACSignals::KeepRecords(const std::vector<std::size_t> &indices){
+template<typename T>
+void BasicSACSignals<T>::KeepRecords(const std::vector<std::size_t> &indices){
     std::vector<size_t> BadIndices;
     if (indices.empty())
         for (std::size_t i=0;i<Size();++i)
@@ -698,21 +956,71 @@ void SACSignals::KeepRecords(const std::vector<std::size_t> &indices){
     return;
 }
 
-EvenSampledSignal SACSignals::MakeNeatStack() const {
+// Read waveforms for records created in meta data only mode.
+// Delta and begin time (possibly shifted) of the records are kept.
+// If a file can't be read anymore, throws (the records stay meta data only).
+template<typename T>
+void BasicSACSignals<T>::LoadWaveforms(const std::size_t &nThreads){
+    if (loaded) return;
+    std::vector<std::size_t> I(Size());
+    for (std::size_t i=0;i<Size();++i) I[i]=i;
+    Modify(I,1,nThreads,[](const std::vector<std::size_t> &){});
+    loaded=true;
+}
+
+// Read-only access can't read the waveforms: use LoadWaveforms() (or the
+// non-const GetData()) first.
+template<typename T>
+const std::vector<BasicEvenSampledSignal<T>> &BasicSACSignals<T>::GetData() const {
+    if (!loaded)
+        for (std::size_t i=0;i<Size();++i)
+            if (MetaDataOnly(i))
+                throw std::runtime_error("Tried to get waveforms of meta data only records, call LoadWaveforms() first.");
+    return data;
+}
+
+// Stack is accumulated in double.
+template<typename T>
+EvenSampledSignal BasicSACSignals<T>::MakeNeatStack() const {
+    std::vector<std::size_t> ind;
+    for (std::size_t i=0;i<Size();++i) ind.push_back(i);
+    return MakeNeatStack(ind);
+}
+
+// Records with the same delta and begin time are packed once and summed by
+// TraceMatrix::SumRows; otherwise stack record by record (operator+= reports
+// the mismatch).
+template<typename T>
+EvenSampledSignal BasicSACSignals<T>::MakeNeatStack(const std::vector<std::size_t> &ind) const {
     EvenSampledSignal ans;
-    if (Size()==0) return ans;
-    for (std::size_t i=0;i<Size();++i) ans+=data[i];
+    if (ind.empty()) return ans;
+
+    const auto &first=data[ind[0]];
+    bool same=true;
+    for (const auto &i:ind)
+        if (fabs(data[i].GetDelta()-first.GetDelta())>1e-5 || fabs(data[i].BeginTime()-first.BeginTime())>1e-5)
+            same=false;
+
+    if (!same) {
+        BasicEvenSampledSignal<T> buf;
+        for (const auto &i:ind) ans+=Trace(i,buf);
+        return ans;
+    }
+
+    ans=EvenSampledSignal(Pack(ind).SumRows(),first.GetDelta(),first.BeginTime(),"--StackResult");
+    ans.SetTag(first.GetTag());
     return ans;
 }
 
-void SACSignals::Mask(const double &t1, const double &t2, const size_t &index) {
+template<typename T>
+void BasicSACSignals<T>::Mask(const double &t1, const double &t2, const size_t &index) {
     std::vector<double> T1(Size(),t1),T2(Size(),t2);
     if (index>Size()) Mask(T1,T2); // default value. Mask all.
     else Mask(T1,T2,{index});
 }
 
-void SACSignals::Mask(const std::vector<double> &t1, const std::vector<double> &t2, const std::vector<size_t> &indicies){
-
+template<typename T>
+void BasicSACSignals<T>::Mask(const std::vector<double> &t1, const std::vector<double> &t2, const std::vector<size_t> &indicies){
     for (std::size_t i: indicies)
         if (i>Size())
             throw std::runtime_error("Mask indicies vector value error.");
@@ -721,36 +1029,57 @@ void SACSignals::Mask(const std::vector<double> &t1, const std::vector<double> &
         throw std::runtime_error("Mask input vector length error.");
 
     if (indicies.empty())
-        for (std::size_t i=0;i<Size();++i) data[i].Mask(t1[i],t2[i]);
+        Modify([&](const std::size_t &i){data[i].Mask(t1[i],t2[i]);});
     else
-        for (std::size_t i: indicies) data[i].Mask(t1[i],t2[i]);
+        Modify(indicies,1,1,[&](const std::vector<std::size_t> &J){data[J[0]].Mask(t1[J[0]],t2[J[0]]);});
 }
 
-void SACSignals::NormalizeToGlobal(){
-    double MaxOriginalAmp=-1;
+template<typename T>
+void BasicSACSignals<T>::NormalizeToGlobal(){
+
+    // same size records in memory: one pass over the packed records.
+    bool InMemory=true;
+    for (std::size_t i=0;i<Size();++i)
+        if (MetaDataOnly(i)) InMemory=false;
+
+    std::vector<double> OriginalAmp;
+    if (InMemory && SameSize() && Size()!=0 && data[0].Size()!=0) OriginalAmp=Pack().MaxAbs();
+    else {
+        OriginalAmp.resize(Size());
+        ForEach([&](const std::size_t &i){
+            BasicEvenSampledSignal<T> buf;
+            OriginalAmp[i]=Trace(i,buf).MaxAmp();
+        });
+    }
     for (std::size_t i=0;i<Size();++i)
-        MaxOriginalAmp=std::max(MaxOriginalAmp,data[i].MaxAmp()*fabs(data[i].GetAmpMultiplier()));
+        OriginalAmp[i]*=fabs(data[i].GetAmpMultiplier());
 
-    for (std::size_t i=0;i<Size();++i){
+    double MaxOriginalAmp=-1;
+    for (const auto &item:OriginalAmp)
+        MaxOriginalAmp=std::max(MaxOriginalAmp,item);
+
+    Modify([&](const std::size_t &i){
         double x=MaxOriginalAmp/fabs(data[i].GetAmpMultiplier());
         data[i]/=x;
-    }
+    });
 }
 
 // Only normalize to the magnitude of the peak.
-void SACSignals::NormalizeToPeak(){
-    for (std::size_t i=0;i<Size();++i)
-        data[i].NormalizeToPeak();
+template<typename T>
+void BasicSACSignals<T>::NormalizeToPeak(){
+    Modify([&](const std::size_t &i){data[i].NormalizeToPeak();});
 }
 
-void SACSignals::NormalizeToSignal(){
-    for (std::size_t i=0;i<Size();++i)
-        data[i].NormalizeToSignal();
+template<typename T>
+void BasicSACSignals<T>::NormalizeToSignal(){
+    Modify([&](const std::size_t &i){data[i].NormalizeToSignal();});
 }
 
-void SACSignals::OutputToSAC(const std::string &prefix, const std::vector<std::size_t> &indices,
+template<typename T>
+void BasicSACSignals<T>::OutputToSAC(const std::string &prefix, const std::vector<std::size_t> &indices,
                              const std::vector<std::map<std::string,double>> &F,
-                             const std::vector<std::map<std::string,std::string>> &M) const {
+                             const std::vector<std::map<std::string,std::string>> &M,
+                             const std::size_t &nThreads) const {
     std::vector<std::size_t> ind;
     if (indices.empty()) {
         ind.resize(Size());
@@ -760,88 +1089,75 @@ void SACSignals::OutputToSAC(const std::string &prefix, const std::vector<std::s
     if (!F.empty() && F.size()!=ind.size()) throw std::runtime_error("Float info length doesn't match.");
     if (!M.empty() && M.size()!=ind.size()) throw std::runtime_error("String info length doesn't match.");
 
-    int npts,nerr,prev_size=0,ltrue=true,lfalse;
-    float dt,bt,*amp=nullptr;
-    std::size_t k=0;
-    for (const std::size_t &i:ind) {
+    ParallelFor(ind.size(),nThreads,[&](const std::size_t &k){
 
+        std::size_t i=ind[k];
         std::string outfile = prefix + std::to_string(i+1)+".sac";
         if (ind.size() == 1) {
 
             outfile = prefix + ".sac";
         }
-        npts=data[i].Size();
-        dt=data[i].GetDelta();
-        bt=data[i].BeginTime();
-
-        if (prev_size!=npts) {
-            delete [] amp;
-            amp = new float [npts];
-            prev_size=npts;
-        }
-        for (int j=0;j<npts;++j) amp[j]=data[i].GetAmp()[j];
+        BasicEvenSampledSignal<T> buf;
+        const auto &item=Trace(i,buf);
 
         // basic info.
-        newhdr();
-        setnhv((char *)"npts",&npts, &nerr, -1);
-        setfhv((char *)"b", &bt, &nerr, -1);
-        setfhv((char *)"delta", &dt, &nerr, -1);
-        setihv((char *)"iftype", (char *)"itime", &nerr, -1, -1);
-        setlhv((char *)"leven", &ltrue, &nerr, -1);
-        setlhv((char *)"lpspol", &ltrue, &nerr, -1);
-        setlhv((char *)"lcalda", &lfalse, &nerr, -1);
+        SACHeader hdr;
+        hdr.SetFloat("b",item.BeginTime());
+        hdr.SetFloat("delta",item.GetDelta());
+        hdr.SetInt("lpspol",1);
+        hdr.SetInt("lcalda",0);
 
         // headers.
         if (F.empty() && M.empty()) {
 
-            const auto &item = GetMData()[i];
-            char st[6]="kstnm",kt[7]="knetwk",gc[6]="gcarc",ede[5]="evdp",elo[5]="evlo",ela[5]="evla",slo[5]="stlo",sla[5]="stla",azimuth[3]="az";
-
-            setkhv(st, (char *)item.stnm.c_str(), &nerr, -1, -1);
-            setkhv(kt, (char *)item.network.c_str(), &nerr, -1, -1);
-
-            float tmpval;
-
-            tmpval = item.gcarc;
-            setfhv(gc, &tmpval, &nerr, -1);
-
-            tmpval = item.evde;
-            setfhv(ede, &tmpval, &nerr, -1);
-
-            tmpval = item.evlo;
-            setfhv(elo, &tmpval, &nerr, -1);
-
-            tmpval = item.evla;
-            setfhv(ela, &tmpval, &nerr, -1);
-
-            tmpval = item.stlo;
-            setfhv(slo, &tmpval, &nerr, -1);
-
-            tmpval = item.stla;
-            setfhv(sla, &tmpval, &nerr, -1);
-
-            tmpval = item.az;
-            setfhv(azimuth, &tmpval, &nerr, -1);
+            hdr.SetKey("kstnm",mdata.Stnm(i));
+            hdr.SetKey("knetwk",mdata.Network(i));
+            hdr.SetFloat("gcarc",mdata.Gcarc()[i]);
+            hdr.SetFloat("evdp",mdata.Evde()[i]);
+            hdr.SetFloat("evlo",mdata.Evlo()[i]);
+            hdr.SetFloat("evla",mdata.Evla()[i]);
+            hdr.SetFloat("stlo",mdata.Stlo()[i]);
+            hdr.SetFloat("stla",mdata.Stla()[i]);
+            hdr.SetFloat("az",mdata.Az()[i]);
         }
         else if (k<F.size()) {
-            for (const auto &item: F[k]){
-                float tmpval=item.second;
-                setfhv((char *)item.first.c_str(), &tmpval, &nerr, -1);
-            }
+            for (const auto &item: F[k])
+                hdr.SetFloat(item.first,item.second);
         }
         else if (k<M.size()) {
-            for (const auto &item: M[k]){
-                setkhv((char *)item.first.c_str(), (char *)item.second.c_str(), &nerr, -1, -1);
-            }
+            for (const auto &item: M[k])
+                hdr.SetKey(item.first,item.second);
         }
-        ++k;
 
-        wsac0((char *)outfile.c_str(),&dt,amp,&nerr,-1);
+        if (!WriteSAC(outfile,hdr,item.GetAmp()))
+            throw std::runtime_error("Can't write SAC file: "+outfile);
+    });
+}
+
+// Copy the records (all records if indices is empty) into the rows of a
+// contiguous aligned matrix, for batch kernels. Records should have the same size.
+template<typename T>
+TraceMatrix<T> BasicSACSignals<T>::Pack(const std::vector<std::size_t> &indices) const {
+    std::vector<std::size_t> ind=indices;
+    if (ind.empty())
+        for (std::size_t i=0;i<Size();++i) ind.push_back(i);
+
+    TraceMatrix<T> ans;
+    BasicEvenSampledSignal<T> buf;
+    for (std::size_t k=0;k<ind.size();++k) {
+        if (ind[k]>=Size())
+            throw std::runtime_error("Pack index out of range.");
+        const auto &amp=Trace(ind[k],buf).GetAmp();
+        if (k==0) ans=TraceMatrix<T>(ind.size(),amp.size());
+        else if (amp.size()!=ans.Cols())
+            throw std::runtime_error("Tried to pack records with different number of points.");
+        std::copy(amp.begin(),amp.end(),ans.Row(k));
     }
-    delete [] amp;
+    return ans;
 }
 
-std::vector<double> SACSignals::PeakAmp(const std::vector<std::size_t> &indices) const{
+template<typename T>
+std::vector<double> BasicSACSignals<T>::PeakAmp(const std::vector<std::size_t> &indices) const{
     std::vector<double> ans;
     if (indices.empty())
         for (std::size_t i=0;i<Size();++i)
@@ -855,7 +1171,8 @@ std::vector<double> SACSignals::PeakAmp(const std::vector<std::size_t> &indices)
     return ans;
 }
 
-std::vector<double> SACSignals::PeakTime(const std::vector<std::size_t> &indices) const{
+template<typename T>
+std::vector<double> BasicSACSignals<T>::PeakTime(const std::vector<std::size_t> &indices) const{
     std::vector<double> ans;
     if (indices.empty())
         for (std::size_t i=0;i<Size();++i)
@@ -869,52 +1186,66 @@ std::vector<double> SACSignals::PeakTime(const std::vector<std::size_t> &indices
     return ans;
 }
 
-void SACSignals::PrintInfo() const {
+template<typename T>
+void BasicSACSignals<T>::PrintInfo() const {
     PrintListInfo();
     std::cout << "====== \n";
     for (std::size_t i=0;i<Size();++i) {
-        std::cout << mdata[i] << '\n';
-        data[i].PrintInfo();
+        BasicEvenSampledSignal<T> buf;
+        std::cout << mdata.Get(i) << '\n';
+        Trace(i,buf).PrintInfo();
         std::cout << "\n------ \n";
     }
 }
 
-void SACSignals::PrintListInfo() const {
+template<typename T>
+void BasicSACSignals<T>::PrintListInfo() const {
     std::cout << "Read from file: " << GetFileListName() << '\n';
     std::cout << "Current valid trace nubmer: " << Size() << '\n';
 }
 
 
-void SACSignals::ReCalcAz(){
+template<typename T>
+void BasicSACSignals<T>::ReCalcAz(){
     for (std::size_t i=0; i<Size(); ++i)
-        mdata[i].az=FindAz(mdata[i].evlo, mdata[i].evla, mdata[i].stlo, mdata[i].stla);
+        mdata.SetAz(i,FindAz(mdata.Evlo()[i], mdata.Evla()[i], mdata.Stlo()[i], mdata.Stla()[i]));
 }
 
-void SACSignals::ReCalcDist(){
+template<typename T>
+void BasicSACSignals<T>::ReCalcDist(){
     for (std::size_t i=0; i<Size(); ++i)
-        mdata[i].gcarc=GcpDistance(mdata[i].evlo, mdata[i].evla, mdata[i].stlo, mdata[i].stla);
+        mdata.SetGcarc(i,GcpDistance(mdata.Evlo()[i], mdata.Evla()[i], mdata.Stlo()[i], mdata.Stla()[i]));
+    indexed=false;
 }
 
 
-void SACSignals::RemoveRecords(const std::vector<std::size_t> &indices){
+template<typename T>
+void BasicSACSignals<T>::RemoveRecords(const std::vector<std::size_t> &indices){
     if (indices.empty()) return;
     auto ind=indices;
     std::sort(ind.begin(),ind.end(),std::greater<std::size_t>());
     for (const auto &i:ind){
-        std::swap(mdata[i],mdata.back());mdata.pop_back();
+        std::size_t last=Size()-1;
+        if (indexed) {
+            IndexRecord(i,false);
+            if (i!=last) IndexRecord(last,false);
+        }
+        mdata.Remove(i);
         std::swap(data[i],data.back());data.pop_back();
+        if (indexed && i!=last) IndexRecord(i,true);
     }
     sorted_by="None";
 }
 
-std::vector<std::pair<double,double>> SACSignals::RemoveTrend(){
-    std::vector<std::pair<double,double>> ans;
-    for (std::size_t i=0;i<Size();++i)
-        ans.push_back(data[i].RemoveTrend());
+template<typename T>
+std::vector<std::pair<double,double>> BasicSACSignals<T>::RemoveTrend(){
+    std::vector<std::pair<double,double>> ans(Size());
+    Modify([&](const std::size_t &i){ans[i]=data[i].RemoveTrend();});
     return ans;
 }
 
-bool SACSignals::SameSamplingRate() const{
+template<typename T>
+bool BasicSACSignals<T>::SameSamplingRate() const{
     if (Size()<=1) return true;
     double dt=data[0].GetDelta();
     for (std::size_t i=1;i<Size();++i)
@@ -923,56 +1254,102 @@ bool SACSignals::SameSamplingRate() const{
     return true;
 }
 
-bool SACSignals::SameSize() const{
+template<typename T>
+bool BasicSACSignals<T>::SameSize() const{
     if (Size()<=1) return true;
-    std::size_t n=data[0].Size();
+    BasicEvenSampledSignal<T> buf;
+    std::size_t n=Trace(0,buf).Size();
     for (std::size_t i=1;i<Size();++i)
-        if (n!=data[i].Size())
+        if (n!=Trace(i,buf).Size())
             return false;
     return true;
 }
 
-void SACSignals::SetBeginTime(const double &t){
+template<typename T>
+void BasicSACSignals<T>::SetBeginTime(const double &t){
     for (auto &item:data)
         item.SetBeginTime(t);
 }
 
-void SACSignals::SortByGcarc() {
+// Waveforms of meta data only records read by the read-only members are
+// cached, up to the given bytes. bytes=0: no caching.
+template<typename T>
+void BasicSACSignals<T>::SetCacheBudget(const std::size_t &bytes){
+    if (bytes==0) cache.reset();
+    else cache=std::make_shared<LRUCache<std::string,std::vector<T>>>(bytes,
+        [](const std::vector<T> &v){return v.size()*sizeof(T);});
+}
+
+template<typename T>
+void BasicSACSignals<T>::SortByGcarc() {
     if (sorted_by=="Gcarc") return;
-    auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){return m1.gcarc<m2.gcarc;};
-    ReorderUseIndex(data.begin(),data.end(),SortWithIndex(mdata.begin(),mdata.end(),cmp));
+    auto gcarc=mdata.Gcarc();
+    auto idx=SortWithIndex(gcarc.begin(),gcarc.end(),false);
+    mdata.Reorder(idx);
+    ReorderUseIndex(data.begin(),data.end(),idx);
     sorted_by="Gcarc";
+    indexed=false;
     return;
 }
 
-void SACSignals::SortByNetwork() {
+template<typename T>
+void BasicSACSignals<T>::SortByNetwork() {
     if (sorted_by=="Network") return;
-    auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){return m1.network<m2.network;};
-    ReorderUseIndex(data.begin(),data.end(),SortWithIndex(mdata.begin(),mdata.end(),cmp));
+    auto names=GetNetworkNames();
+    auto idx=SortWithIndex(names.begin(),names.end(),false);
+    mdata.Reorder(idx);
+    ReorderUseIndex(data.begin(),data.end(),idx);
     sorted_by="Network";
+    indexed=false;
     return;
 }
 
-void SACSignals::SortByStnm() {
+template<typename T>
+void BasicSACSignals<T>::SortByStnm() {
     if (sorted_by=="Stnm") return;
-    auto cmp=[](const SACMetaData &m1, const SACMetaData &m2){return m1.stnm<m2.stnm;};
-    ReorderUseIndex(data.begin(),data.end(),SortWithIndex(mdata.begin(),mdata.end(),cmp));
+    auto names=GetStationNames();
+    auto idx=SortWithIndex(names.begin(),names.end(),false);
+    mdata.Reorder(idx);
+    ReorderUseIndex(data.begin(),data.end(),idx);
     sorted_by="Stnm";
+    indexed=false;
     return;
 }
 
-std::vector<double> SACSignals::SNR(const double &nt1, const double &nt2,
+template<typename T>
+std::vector<double> BasicSACSignals<T>::SNR(const double &nt1, const double &nt2,
                                     const double &st1, const double &st2,
                                     const std::vector<double> &na,
                                     const std::vector<double> &sa) const{
-    std::vector<double> ans;
-    for (std::size_t i=0;i<Size();++i)
-        ans.push_back(data[i].SNR(na.empty()?0:na[i]+nt1,na.empty()?0:na[i]+nt2,
-                                  sa.empty()?0:sa[i]+st1,sa.empty()?0:sa[i]+st2));
+    std::vector<double> ans(Size());
+    ForEach([&](const std::size_t &i){
+        BasicEvenSampledSignal<T> buf;
+        ans[i]=Trace(i,buf).SNR(na.empty()?0:na[i]+nt1,na.empty()?0:na[i]+nt2,
+                                sa.empty()?0:sa[i]+st1,sa.empty()?0:sa[i]+st2);
+    });
     return ans;
 }
 
-void SACSignals::StretchToFit(const EvenSampledSignal &s, const double &t1, const double &t2,
+// windows: {nt1,nt2,st1,st2}, relative to na[i] and sa[i] (absolute times if
+// na/sa are empty). ans[i][j]: SNR of trace i in window j. The Hilbert
+// transform of each trace is calculated once for all windows.
+template<typename T>
+std::vector<std::vector<double>> BasicSACSignals<T>::SNR(const std::vector<std::array<double,4>> &windows,
+                                                 const std::vector<double> &na,
+                                                 const std::vector<double> &sa) const{
+    std::vector<std::vector<double>> ans(Size());
+    ForEach([&](const std::size_t &i){
+        double n=(na.empty()?0:na[i]),s=(sa.empty()?0:sa[i]);
+        std::vector<std::array<double,4>> W;
+        for (const auto &w: windows) W.push_back({{n+w[0],n+w[1],s+w[2],s+w[3]}});
+        BasicEvenSampledSignal<T> buf;
+        ans[i]=Trace(i,buf).SNR(W);
+    });
+    return ans;
+}
+
+template<typename T>
+void BasicSACSignals<T>::StretchToFit(const BasicEvenSampledSignal<T> &s, const double &t1, const double &t2,
                               const double &h1, const double &h2, const double &ampLevel,
                               const bool &adaptive, const std::size_t method){
 
@@ -981,27 +1358,28 @@ void SACSignals::StretchToFit(const EvenSampledSignal &s, const double &t1, cons
     if (data[0].GetDelta()!=s.GetDelta())
         throw std::runtime_error("In StretchToFit, input signals have different sample rate.");
 
-    for (std::size_t i=0;i<Size();++i)
+    Modify([&](const std::size_t &i){
         data[i]=data[i].StretchToFit(s,t1,t2,h1,h2,ampLevel,adaptive,method);
+    });
 
     return;
 }
 
-void SACSignals::StripSignal(const EvenSampledSignal &s2, const std::vector<double> &dt){
+template<typename T>
+void BasicSACSignals<T>::StripSignal(const BasicEvenSampledSignal<T> &s2, const std::vector<double> &dt){
 
     if (!dt.empty() && Size()!=dt.size())
         throw std::runtime_error("Strip signal time shift have different size.");
 
     if (dt.empty())
-        for (std::size_t i=0;i<Size();++i)
-            data[i].StripSignal(s2);
+        Modify([&](const std::size_t &i){data[i].StripSignal(s2);});
     else
-        for (std::size_t i=0;i<Size();++i)
-            data[i].StripSignal(s2,dt[i]);
+        Modify([&](const std::size_t &i){data[i].StripSignal(s2,dt[i]);});
     return;
 }
 
-void SACSignals::StripSignal(const std::vector<EvenSampledSignal> &s, const std::vector<double> &dt){
+template<typename T>
+void BasicSACSignals<T>::StripSignal(const std::vector<BasicEvenSampledSignal<T>> &s, const std::vector<double> &dt){
 
     if (Size()!=s.size())
         throw std::runtime_error("Strip signal number of signals are different.");
@@ -1010,122 +1388,233 @@ void SACSignals::StripSignal(const std::vector<EvenSampledSignal> &s, const std:
         throw std::runtime_error("Strip signal time shift have different size.");
 
     if (dt.empty())
-        for (std::size_t i=0;i<Size();++i)
-            data[i].StripSignal(s[i]);
+        Modify([&](const std::size_t &i){data[i].StripSignal(s[i]);});
     else
-        for (std::size_t i=0;i<Size();++i)
-            data[i].StripSignal(s[i],dt[i]);
+        Modify([&](const std::size_t &i){data[i].StripSignal(s[i],dt[i]);});
 }
 
-void SACSignals::WaterLevelDecon(const EvenSampledSignal &s, const double &wl){
-    for (std::size_t i=0;i<Size();++i)
-        data[i].WaterLevelDecon(s,wl);
+// Copy the rows of M back into the records (reverse of Pack).
+// Delta, begin time and file name are kept; peak and amplitude multiplier are reset.
+template<typename T>
+void BasicSACSignals<T>::Unpack(const TraceMatrix<T> &M, const std::vector<std::size_t> &indices){
+    std::vector<std::size_t> ind=indices;
+    if (ind.empty())
+        for (std::size_t i=0;i<Size();++i) ind.push_back(i);
+
+    if (ind.size()!=M.Rows())
+        throw std::runtime_error("Unpack matrix rows doesn't match record number.");
+    for (const auto &i:ind)
+        if (i>=Size())
+            throw std::runtime_error("Unpack index out of range.");
+
+    ParallelFor(ind.size(),threads,[&](const std::size_t &k){
+        auto &item=data[ind[k]];
+        item=BasicEvenSampledSignal<T>(std::vector<T> (M.Row(k),M.Row(k)+M.Cols()),
+                                       item.GetDelta(),item.BeginTime(),item.GetFileName());
+    });
 }
 
-void SACSignals::WaterLevelDecon(SACSignals &D, const double &wl){
+template<typename T>
+void BasicSACSignals<T>::WaterLevelDecon(const BasicEvenSampledSignal<T> &s, const double &wl){
+    Modify([&](const std::size_t &i){data[i].WaterLevelDecon(s,wl);});
+}
+
+template<typename T>
+void BasicSACSignals<T>::WaterLevelDecon(BasicSACSignals<T> &D, const double &wl){
     //check size;
     if (Size()!=D.Size())
         throw std::runtime_error("Waterlevel decon source signal array size doesn't match.");
+    Modify([&](const std::size_t &i){
+        BasicEvenSampledSignal<T> buf;
+        data[i].WaterLevelDecon(D.Trace(i,buf),wl);
+    });
+}
+
+// Pack all records (and meta data) into one archive file.
+template<typename T>
+void BasicSACSignals<T>::WriteArchive(const std::string &outfile) const {
+    SACArchive::Writer W(outfile);
+    WriteArchive(W);
+    W.Close();
+}
+
+// Append all records to an open archive (e.g. a sink of StreamSACSignals).
+template<typename T>
+void BasicSACSignals<T>::WriteArchive(SACArchive::Writer &W) const {
+    BasicEvenSampledSignal<T> buf;
     for (std::size_t i=0;i<Size();++i)
-        data[i].WaterLevelDecon(D.data[i],wl);
+        W.Add(Trace(i,buf),mdata.Get(i));
 }
 
 
 // Member template function definitions.
+
+// Modify the records I[], B at a time: f(J) runs on blocks J of I (in
+// parallel). Meta data only records are read through Trace() (the cache)
+// right before their block runs and are kept in memory afterwards. They are
+// done first: if one can't be read (or f throws), they are all put back to
+// meta data only before the exception is passed on.
 template<typename T>
-void SACSignals::CheckAndCutToWindow(const std::vector<T> &center_time,
+template<typename F>
+void BasicSACSignals<T>::Modify(const std::vector<std::size_t> &I, const std::size_t &B,
+                                const std::size_t &nThreads, const F &f){
+
+    std::vector<std::size_t> todo,rest;
+    for (const auto &i:I) (MetaDataOnly(i)?todo:rest).push_back(i);
+
+    auto Run=[&](const std::vector<std::size_t> &K, const bool &read){
+        ParallelFor((K.size()+B-1)/B,nThreads,[&](const std::size_t &k){
+            std::vector<std::size_t> J(K.begin()+k*B,K.begin()+std::min(K.size(),(k+1)*B));
+            if (read)
+                for (const auto &i:J) {
+                    BasicEvenSampledSignal<T> buf;
+                    Trace(i,buf);
+                    data[i]=std::move(buf);
+                }
+            f(J);
+        });
+    };
+
+    std::vector<BasicEvenSampledSignal<T>> P;
+    for (const auto &i:todo) P.push_back(data[i]);
+    try {
+        Run(todo,true);
+    }
+    catch (...) {
+        for (std::size_t j=0;j<todo.size();++j) data[todo[j]]=std::move(P[j]);
+        throw;
+    }
+    Run(rest,false);
+}
+
+// Modify each record: f(i).
+template<typename T>
+template<typename F>
+void BasicSACSignals<T>::Modify(const F &f){
+    std::vector<std::size_t> I(Size());
+    for (std::size_t i=0;i<Size();++i) I[i]=i;
+    Modify(I,1,threads,[&](const std::vector<std::size_t> &J){f(J[0]);});
+}
+template<typename T>
+template<typename U>
+void BasicSACSignals<T>::CheckAndCutToWindow(const std::vector<U> &center_time,
                                      const double &t1, const double &t2){
     //check size;
     if (Size()!=center_time.size())
         throw std::runtime_error("Cut reference time array size doesn't match.");
+    std::vector<char> good(Size(),0);
+    Modify([&](const std::size_t &i){
+        good[i]=data[i].CheckAndCutToWindow(center_time[i]+t1,center_time[i]+t2);
+    });
     std::vector<std::size_t> BadIndices;
     for (std::size_t i=0;i<Size();++i)
-        if (!data[i].CheckAndCutToWindow(center_time[i]+t1,center_time[i]+t2))
-            BadIndices.push_back(i);
+        if (!good[i]) BadIndices.push_back(i);
     RemoveRecords(BadIndices);
 }
-void SACSignals::CheckAndCutToWindow(const double &t1, const double &t2){
+template<typename T>
+void BasicSACSignals<T>::CheckAndCutToWindow(const double &t1, const double &t2){
     CheckAndCutToWindow(std::vector<double> (Size(),0),t1,t2);
 }
 
 template<typename T>
-void SACSignals::FindPeakAround(const std::vector<T> &center_time, const double &wl, const bool &positiveOnly){
+template<typename U>
+void BasicSACSignals<T>::FindPeakAround(const std::vector<U> &center_time, const double &wl, const bool &positiveOnly){
     //check size;
     if (Size()!=center_time.size())
         throw std::runtime_error("FindPeak time array size doesn't match.");
-    for (std::size_t i=0;i<Size();++i)
-        data[i].FindPeakAround(center_time[i],wl,positiveOnly);
+    Modify([&](const std::size_t &i){data[i].FindPeakAround(center_time[i],wl,positiveOnly);});
 }
 
-void SACSignals::FindPeakAround(const double &center_time, const double &wl, const bool &positiveOnly){
+template<typename T>
+void BasicSACSignals<T>::FindPeakAround(const double &center_time, const double &wl, const bool &positiveOnly){
     FindPeakAround(std::vector<double> (Size(),center_time),wl,positiveOnly);
 }
 
 template<typename T>
-void SACSignals::FlipReverseSum(const std::vector<T> &t){
+template<typename U>
+void BasicSACSignals<T>::FlipReverseSum(const std::vector<U> &t){
     if (Size()!=t.size())
         throw std::runtime_error("FRS center time point array size doesn't match.");
-    for (std::size_t i=0;i<Size();++i)
-        data[i].FlipReverseSum(t[i]);
+    Modify([&](const std::size_t &i){data[i].FlipReverseSum(t[i]);});
 }
-void SACSignals::FlipReverseSum(const double &t){
+template<typename T>
+void BasicSACSignals<T>::FlipReverseSum(const double &t){
     FlipReverseSum(std::vector<double> (Size(),t));
 }
 
 // Set the given time to zero.
 template<typename T>
-void SACSignals::ShiftTime(const std::vector<T> &t){
+template<typename U>
+void BasicSACSignals<T>::ShiftTime(const std::vector<U> &t){
     //check size;
     if (Size()!=t.size())
         throw std::runtime_error("Time shift array size doesn't match.");
     for (std::size_t i=0;i<Size();++i) {
         data[i].ShiftTime(-t[i]);
-        for (auto it=mdata[i].tt.begin();it!=mdata[i].tt.end();++it)
-            it->second-=t[i];
+        mdata.ShiftTravelTimes(i,t[i]);
     }
 }
 template<typename T>
-void SACSignals::ShiftTime(const T &t){
-    ShiftTime(std::vector<T> (Size(),t));
+template<typename U>
+void BasicSACSignals<T>::ShiftTime(const U &t){
+    ShiftTime(std::vector<U> (Size(),t));
 }
 
-void SACSignals::ShiftTimeReferenceToPeak(){
+template<typename T>
+void BasicSACSignals<T>::ShiftTimeReferenceToPeak(){
     ShiftTime(PeakTime());
 }
 
+template<typename T>
 std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
-SACSignals::XCorrStack(const double &center_time, const double &t1, const double &t2, const int loopN) const {
+BasicSACSignals<T>::XCorrStack(const double &center_time, const double &t1, const double &t2, const int loopN) const {
     return XCorrStack(std::vector<double> (Size(),center_time),t1,t2,loopN);
 }
 
+template<typename T>
 std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
-SACSignals::XCorrStack(const std::vector<double> &center_time, const double &t1, const double &t2, const int loopN) const{
+BasicSACSignals<T>::XCorrStack(const std::vector<double> &center_time, const double &t1, const double &t2, const int loopN) const{
 
     if (!SameSamplingRate())
         throw std::runtime_error("Tried to XCorrStack signals with different sample rate.");
     if (center_time.size()!=Size())
         throw std::runtime_error("In XCorrStack, # of signals doesn't agree with # of windows.");
+
+    std::vector<std::size_t> ind(Size());
+    for (std::size_t i=0;i<Size();++i) ind[i]=i;
+    return XCorrStack(ind,center_time,t1,t2,loopN);
+}
+
+// XCorrStack on records ind (same sampling rate), center_time[k] is for record ind[k].
+// Outputs are in the order of ind.
+template<typename T>
+std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
+BasicSACSignals<T>::XCorrStack(const std::vector<std::size_t> &ind, const std::vector<double> &center_time,
+                               const double &t1, const double &t2, const int loopN) const{
+
     if (t1>=t2) throw std::runtime_error("XCorrStack window length <=0.");
 
     // will return {shift time, ccc}, {stack(averaged) of valid overlapping part of shifted orignal signal, stack stdandard deviation}
     // If the trace is not used in the satck, ccc will be zero (use ccc as weights).
 
     std::pair<std::vector<double>, std::vector<double>> ans;
-    if (Size()==0) return {ans,{EvenSampledSignal(),EvenSampledSignal()}};
+    if (ind.empty()) return {ans,{EvenSampledSignal(),EvenSampledSignal()}};
 
 
     // Find the good records which has waveform avaliable within its XCorrStack window.
     std::vector<std::size_t> GoodIndex;
-    for (std::size_t i=0;i<Size();++i)
-        if (data[i].CheckWindow(center_time[i]+t1,center_time[i]+t2))
+    BasicEvenSampledSignal<T> buf;
+    for (std::size_t i=0;i<ind.size();++i)
+        if (Trace(ind[i],buf).CheckWindow(center_time[i]+t1,center_time[i]+t2))
             GoodIndex.push_back(i);
 
 
 
     // First stack: align at the peak within their window, then stack according to polarity.
+    // stacks are in double.
     EvenSampledSignal S0;
     for (const auto &i:GoodIndex) {
-        auto Tmp=data[i];
+        auto Tmp=GetSignal(ind[i]);
         Tmp.ShiftTime(-center_time[i]);
         Tmp.FindPeakAround(t1+(t2-t1)/2,(t2-t1)/2);
         Tmp.ShiftTimeReferenceToPeak();
@@ -1140,7 +1629,7 @@ SACSignals::XCorrStack(const std::vector<double> &center_time, const double &t1,
     // First stack second try: directly stack the windowed section.
     if (S0.Size()==0) {
         for (const auto &i:GoodIndex) {
-            auto Tmp=data[i];
+            auto Tmp=GetSignal(ind[i]);
             Tmp.ShiftTime(-center_time[i]);
             Tmp.CheckAndCutToWindow(t1,t2);
             Tmp.NormalizeToSignal();
@@ -1162,9 +1651,9 @@ SACSignals::XCorrStack(const std::vector<double> &center_time, const double &t1,
         double newEndTime=std::numeric_limits<double>::max();
         for (const auto &i: GoodIndex) {
 
-            auto res=S.CrossCorrelation(t1,t2,data[i],center_time[i]+t1,center_time[i]+t2);
+            auto Tmp=GetSignal(ind[i]);
+            auto res=S.CrossCorrelation(t1,t2,Tmp,center_time[i]+t1,center_time[i]+t2);
 
-            auto Tmp=data[i];
             Tmp.ShiftTime(-center_time[i]);
 
             if (Tmp.CheckWindow(t1-res.first,t2-res.first)) {
@@ -1173,11 +1662,11 @@ SACSignals::XCorrStack(const std::vector<double> &center_time, const double &t1,
                 Tmp.NormalizeToWindow(t1,t2);
                 newBeginTime=std::max(newBeginTime,Tmp.BeginTime());
                 newEndTime=std::min(newEndTime,Tmp.EndTime());
-                TmpData.push_back(Tmp);
+                TmpData.emplace_back(Tmp);
             }
         }
 
-        std::size_t NPTS=(std::size_t)floor((newEndTime-newBeginTime)/GetDelta());
+        std::size_t NPTS=(std::size_t)floor((newEndTime-newBeginTime)/data[ind[0]].GetDelta());
         for (auto &item: TmpData) {
             item.CheckAndCutToNPTS(newBeginTime,NPTS);
             item.SetBeginTime(newBeginTime);
@@ -1186,9 +1675,9 @@ SACSignals::XCorrStack(const std::vector<double> &center_time, const double &t1,
     }
 
     // Traces not contributing to ESW have ccc=nan.
-    std::vector<double> CCC(Size(),0.0/0.0),AlignTime(Size(),0);
+    std::vector<double> CCC(ind.size(),0.0/0.0),AlignTime(ind.size(),0);
     for (const auto &i: GoodIndex) {
-        auto res=S.CrossCorrelation(t1,t2,data[i],center_time[i]+t1,center_time[i]+t2);
+        auto res=S.CrossCorrelation(t1,t2,Trace(ind[i],buf),center_time[i]+t1,center_time[i]+t2);
         AlignTime[i]=-res.first;
         CCC[i]=res.second;
     }
@@ -1201,91 +1690,32 @@ End of member function/operator definitions. -----------------------------------
 ----------------------------------------------------------------------------- */
 
 // Non-member functions.
-std::istream &operator>>(std::istream &is, SACSignals &item){
+template<typename T>
+std::istream &operator>>(std::istream &is, BasicSACSignals<T> &item){
 
     item.Clear();
+    std::vector<std::string> infiles;
     std::string sacfilename;
-    char file[300],stnm1[20],netwk1[20],p[20];
-    char st[6]="kstnm",kt[7]="knetwk",gc[6]="gcarc",ede[5]="evdp",elo[5]="evlo",ela[5]="evla",slo[5]="stlo",sla[5]="stla",azimuth[3]="az";
-    char tname[][3]={"t0","t1","t2","t3","t4","t5","t6","t7","t8","t9"};
-    char pname[][4]={"kt0","kt1","kt2","kt3","kt4","kt5","kt6","kt7","kt8","kt9"};
-    std::string stnm,netwk;
-    std::map<std::string,double> M;
-    int rawnpts,maxl=MAXL,nerr;
-    float rawbeg,rawdel,gcarc,t,evde,evlo,evla,stlo,stla,az;
-    float *rawdata = new float[MAXL];
-    std::vector<double> D;
-
-    while (is >> sacfilename){
-        strcpy(file,sacfilename.c_str());
-        rsac1(file,rawdata,&rawnpts,&rawbeg,&rawdel,&maxl,&nerr,strlen(file));
-        if (nerr!=0) continue; // ignore unevenly sampled records.
-
-        D.resize(rawnpts);
-        for (int i=0;i<rawnpts;++i) D[i]=rawdata[i];
-
-        EvenSampledSignal Tmp(D,rawdel,rawbeg,sacfilename);
-        item.data.push_back(Tmp);
-
-        // deal with headers, we only pull these headers:
-        // network code, station code, gcarc, traveltimes,
-        // event lon/lat, station lon/lat.
-        M.clear();
-
-        // to hide SAC warning.
-        const int stdoutfd(dup(fileno(stdout)));
-        int newstdout = open("/dev/null",O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
-        dup2(newstdout, fileno(stdout));
-        close(newstdout);
-        // to hide SAC warning.
-
-        getkhv(st,stnm1,&nerr,5,20);
-        std::string tmpstr(stnm1);
-        stnm=tmpstr.substr(0,tmpstr.find_first_of(" \n\r\t"));
-
-        getkhv(kt,netwk1,&nerr,6,20);
-        tmpstr=std::string(netwk1);
-        netwk=tmpstr.substr(0,tmpstr.find_first_of(" \n\r\t"));
-
-        for (std::size_t i=0;i<10;++i) {
-            getfhv(tname[i],&t,&nerr,2);
-            getkhv(pname[i],p,&nerr,3,20);
-            std::string tmpstr(p);
-            tmpstr=tmpstr.substr(0,tmpstr.find_first_of(" \n\r\t"));
-            if (tmpstr!="-12345") M[tmpstr]=t;
-        }
-        getfhv(gc,&gcarc,&nerr,5);
-        getfhv(ede,&evde,&nerr,4);
-        getfhv(elo,&evlo,&nerr,4);
-        getfhv(ela,&evla,&nerr,4);
-        getfhv(slo,&stlo,&nerr,4);
-        getfhv(sla,&stla,&nerr,4);
-        getfhv(azimuth,&az,&nerr,2);
-
-        // to hide SAC warning
-        fflush(stdout);
-        dup2(stdoutfd, fileno(stdout));
-        close(stdoutfd);
-        // to hide SAC warning
-
-        item.mdata.push_back(SACMetaData(stnm,netwk,gcarc,az,evde,evlo,evla,stlo,stla,M));
-    }
-    delete [] rawdata;
+    while (is >> sacfilename) infiles.push_back(sacfilename);
 
+    item.LoadSACFiles(infiles);
     return is;
 }
 
-SACSignals operator*(const SACSignals &input,const double &a){
-    SACSignals ans(input);
-    for (auto &item:ans.data) item*=a;
+template<typename T>
+BasicSACSignals<T> operator*(const BasicSACSignals<T> &input,const double &a){
+    BasicSACSignals<T> ans(input);
+    ans*=a;
     return ans;
 }
-SACSignals operator*(const double &a, const SACSignals &input){
+template<typename T>
+BasicSACSignals<T> operator*(const double &a, const BasicSACSignals<T> &input){
     return input*a;
 }
-SACSignals operator-(const SACSignals &input,const EvenSampledSignal &item){
-    SACSignals ans(input);
-    for (std::size_t i=0;i<ans.Size();++i) ans.data[i]-=item;
+template<typename T>
+BasicSACSignals<T> operator-(const BasicSACSignals<T> &input,const BasicEvenSampledSignal<T> &item){
+    BasicSACSignals<T> ans(input);
+    ans-=item;
     return ans;
 }
 
@@ -0,0 +1,288 @@
+#ifndef ASU_SACSIGNALSVIEW
+#define ASU_SACSIGNALSVIEW
+
+#include<vector>
+#include<string>
+#include<cmath>
+#include<limits>
+#include<array>
+#include<stdexcept>
+
+#include<SACSignals.hpp>
+#include<SortWithIndex.hpp>
+#include<Lon2360.hpp>
+
+/*************************************************************
+ * This C++ template class is a read-only view of some records of
+ * a SACSignals object, in a given order, without copying them.
+ *
+ * A view holds a reference to the parent SACSignals and a list of record
+ * indices. Selecting, filtering and sorting a view only changes its index
+ * list; the traces and meta data stay in the parent. The parent must
+ * outlive the view and its records should not be added, removed or
+ * reordered while the view is used.
+ *
+ *     SACSignals s("list");
+ *     SACSignalsView v(s);
+ *     v.CheckDist(60,80);
+ *     v.SortByGcarc();
+ *     auto ans=v.XCorrStack(v.GetTravelTimes("S"),-15,15);
+ *
+ * Index i of the member functions below is the position in the view.
+ * Filters keep the order of the view (unlike SACSignals::RemoveRecords).
+ *
+ * constructor input(s):
+ * const SACSignals &parent      ----  Parent.
+ * const vector<size_t> &indices ----  (default: all records) Record indices in the parent.
+ *
+ * member function(s):
+ * const vector<size_t> &GetIndices() const  ----  Record indices in the parent.
+ * SACSignals Copy() const                   ----  Deep copy of the viewed records.
+ * BasicSACSignalsView Select(indices) const ----  A view of some records of this view.
+ * Others are the same as the SACSignals members of the same name.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: view, subset, zero-copy, permutation, sac.
+*************************************************************/
+
+template<typename T>
+class BasicSACSignalsView {
+
+    const BasicSACSignals<T> *parent;
+    std::vector<std::size_t> index;
+
+    // parent members taking an index list treat an empty list as "all records".
+    template<typename R, typename F>
+    R Call(const F &f) const {return (index.empty()?R():f(index));}
+
+    template<typename F>
+    void Filter(const F &keep){
+        std::vector<std::size_t> ans;
+        for (std::size_t i=0;i<Size();++i)
+            if (keep(index[i])) ans.push_back(index[i]);
+        index=ans;
+    }
+
+    // corr(i,s): cross correlation {shift,ccc} of record i of the view, s is its trace.
+    template<typename F>
+    std::pair<std::vector<double>,std::vector<double>> XCorr(const F &corr) const {
+        std::pair<std::vector<double>,std::vector<double>> ans;
+        ans.first.resize(Size());
+        ans.second.resize(Size());
+        ParallelFor(Size(),parent->threads,[&](const std::size_t &i){
+            BasicEvenSampledSignal<T> buf;
+            std::tie(ans.first[i],ans.second[i])=corr(i,parent->Trace(index[i],buf));
+        });
+        return ans;
+    }
+
+    template<typename K>
+    void SortBy(std::vector<K> key){
+        auto idx=SortWithIndex(key.begin(),key.end(),false);
+        ReorderUseIndex(index.begin(),index.end(),idx);
+    }
+
+public:
+
+    BasicSACSignalsView (const BasicSACSignals<T> &s) : parent(&s), index(s.Size()) {
+        for (std::size_t i=0;i<s.Size();++i) index[i]=i;
+    }
+
+    BasicSACSignalsView (const BasicSACSignals<T> &s, const std::vector<std::size_t> &indices) : parent(&s), index(indices) {
+        for (const auto &i:index)
+            if (i>=s.Size())
+                throw std::runtime_error("SACSignalsView index out of range.");
+    }
+
+    std::size_t Size() const {return index.size();}
+    const std::vector<std::size_t> &GetIndices() const {return index;}
+    const BasicSACSignals<T> &GetParent() const {return *parent;}
+
+    BasicSACSignals<T> Copy() const {
+        return (index.empty()?BasicSACSignals<T>():BasicSACSignals<T>(*parent,index));
+    }
+
+    BasicSACSignalsView Select(const std::vector<std::size_t> &indices) const {
+        std::vector<std::size_t> ans;
+        for (const auto &i:indices) {
+            if (i>=Size())
+                throw std::runtime_error("SACSignalsView select index out of range.");
+            ans.push_back(index[i]);
+        }
+        return BasicSACSignalsView(*parent,ans);
+    }
+
+    // Selections (only change the index list).
+    void CheckAz(const double &d1=0, const double &d2=0){
+        if (d1==d2) return;
+        double lowerBound=Lon2360(d1), upperBound=Lon2360(d2);
+        const auto &az=parent->mdata.Az();
+        if (lowerBound>upperBound)
+            Filter([&](const std::size_t &i){return !(Lon2360(az[i])<lowerBound && Lon2360(az[i])>upperBound);});
+        else
+            Filter([&](const std::size_t &i){return !(Lon2360(az[i])<lowerBound || Lon2360(az[i])>upperBound);});
+    }
+
+    void CheckDist(const double &d1=-1, const double &d2=181){
+        const auto &gcarc=parent->mdata.Gcarc();
+        Filter([&](const std::size_t &i){return !(gcarc[i]<d1 || gcarc[i]>d2);});
+    }
+
+    void CheckPhase(const std::string &phase, const double &t1=0, const double &t2=std::numeric_limits<double>::max()){
+        const std::vector<double> *tt=parent->mdata.Phase(phase);
+        Filter([&](const std::size_t &i){
+            return !(tt==nullptr || std::isnan((*tt)[i]) || (*tt)[i]<t1 || (*tt)[i]>t2);
+        });
+    }
+
+    void SortByGcarc() {SortBy(GetDistances());}
+    void SortByNetwork() {SortBy(GetNetworkNames());}
+    void SortByStnm() {SortBy(GetStationNames());}
+
+    // Read-only members.
+    bool SameSamplingRate() const {
+        for (std::size_t i=1;i<Size();++i)
+            if (parent->data[index[i]].GetDelta()!=parent->data[index[0]].GetDelta())
+                return false;
+        return true;
+    }
+    double GetDelta() const {return ((Size()>0 && SameSamplingRate())?parent->data[index[0]].GetDelta():0);}
+
+    BasicEvenSampledSignal<T> GetSignal(const std::size_t &i) const {
+        if (i>=Size())
+            throw std::runtime_error("GetSignal index out of range.");
+        return parent->GetSignal(index[i]);
+    }
+
+    std::vector<std::string> GetFileList() const {
+        std::vector<std::string> ans;
+        for (const auto &i:index) ans.push_back(parent->data[i].GetFileName());
+        return ans;
+    }
+    std::vector<std::string> GetStationNames() const {
+        std::vector<std::string> ans;
+        for (const auto &i:index) ans.push_back(parent->mdata.Stnm(i));
+        return ans;
+    }
+    std::vector<std::string> GetNetworkNames() const {
+        std::vector<std::string> ans;
+        for (const auto &i:index) ans.push_back(parent->mdata.Network(i));
+        return ans;
+    }
+
+    std::vector<double> BeginTime() const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->BeginTime(I);});
+    }
+    std::vector<double> EndTime() const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->EndTime(I);});
+    }
+    std::vector<double> GetDistances() const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->GetDistances(I);});
+    }
+    std::vector<double> GetTravelTimes(const std::string &phase) const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->GetTravelTimes(phase,I);});
+    }
+    std::vector<double> PeakAmp() const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->PeakAmp(I);});
+    }
+    std::vector<double> PeakTime() const {
+        return Call<std::vector<double>>([&](const std::vector<std::size_t> &I){return parent->PeakTime(I);});
+    }
+    std::vector<std::vector<double>> GetWaveforms() const {
+        return Call<std::vector<std::vector<double>>>([&](const std::vector<std::size_t> &I){return parent->GetWaveforms(I);});
+    }
+    std::vector<std::pair<std::vector<double>,std::vector<double>>> GetTimeAndWaveforms() const {
+        return Call<std::vector<std::pair<std::vector<double>,std::vector<double>>>>(
+            [&](const std::vector<std::size_t> &I){return parent->GetTimeAndWaveforms(I);});
+    }
+    TraceMatrix<T> Pack() const {
+        return Call<TraceMatrix<T>>([&](const std::vector<std::size_t> &I){return parent->Pack(I);});
+    }
+
+    std::pair<std::vector<double>,std::vector<double>>
+    CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
+                     const std::vector<BasicEvenSampledSignal<T>> &items, const double &h1, const double &h2,
+                     const int &Flip=0, const std::pair<int,int> &ShiftLimit=
+                     {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                     const bool &SubSample=false) const {
+        if (Size()!=items.size())
+            throw std::runtime_error("In CrossCorrelation, signal size doesn't match ...");
+        return XCorr([&](const std::size_t &i, const BasicEvenSampledSignal<T> &s){
+            return s.CrossCorrelation(t1[i],t2[i],items[i],h1,h2,Flip,ShiftLimit,SubSample);
+        });
+    }
+    std::pair<std::vector<double>,std::vector<double>>
+    CrossCorrelation(const std::vector<double> &t1, const std::vector<double> &t2,
+                     const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
+                     const int &Flip=0, const std::pair<int,int> &ShiftLimit=
+                     {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                     const bool &SubSample=false) const {
+        if (!item.CheckWindow(h1,h2)) {
+            std::cerr << "CrossCorrelation window on signal 2 is not proper." << std::endl;
+            return {std::vector<double> (Size(),0),std::vector<double> (Size(),0)};
+        }
+        CrossCorrelationEngine E(item.GetAmp().begin()+item.LocateTime(h1),
+                                 item.GetAmp().begin()+item.LocateTime(h2)+1,Flip,ShiftLimit);
+        return XCorr([&](const std::size_t &i, const BasicEvenSampledSignal<T> &s){
+            return s.CrossCorrelation(t1[i],t2[i],E,SubSample);
+        });
+    }
+    std::pair<std::vector<double>,std::vector<double>>
+    CrossCorrelation(const double &t1, const double &t2,
+                     const BasicEvenSampledSignal<T> &item, const double &h1, const double &h2,
+                     const int &Flip=0, const std::pair<int,int> &ShiftLimit=
+                     {std::numeric_limits<int>::min(),std::numeric_limits<int>::max()},
+                     const bool &SubSample=false) const {
+        return CrossCorrelation(std::vector<double> (Size(),t1),std::vector<double> (Size(),t2),item,h1,h2,Flip,ShiftLimit,SubSample);
+    }
+
+    EvenSampledSignal MakeNeatStack() const {return parent->MakeNeatStack(index);}
+
+    std::vector<double> SNR(const double &nt1, const double &nt2,
+                            const double &st1, const double &st2,
+                            const std::vector<double> &na=std::vector<double> (),
+                            const std::vector<double> &sa=std::vector<double> ()) const {
+        std::vector<double> ans(Size());
+        ParallelFor(Size(),parent->threads,[&](const std::size_t &i){
+            BasicEvenSampledSignal<T> buf;
+            ans[i]=parent->Trace(index[i],buf).SNR(na.empty()?0:na[i]+nt1,na.empty()?0:na[i]+nt2,
+                                                   sa.empty()?0:sa[i]+st1,sa.empty()?0:sa[i]+st2);
+        });
+        return ans;
+    }
+
+    // see SACSignals::SNR(windows,na,sa).
+    std::vector<std::vector<double>> SNR(const std::vector<std::array<double,4>> &windows,
+                                         const std::vector<double> &na=std::vector<double> (),
+                                         const std::vector<double> &sa=std::vector<double> ()) const {
+        std::vector<std::vector<double>> ans(Size());
+        ParallelFor(Size(),parent->threads,[&](const std::size_t &i){
+            double n=(na.empty()?0:na[i]),s=(sa.empty()?0:sa[i]);
+            std::vector<std::array<double,4>> W;
+            for (const auto &w: windows) W.push_back({{n+w[0],n+w[1],s+w[2],s+w[3]}});
+            BasicEvenSampledSignal<T> buf;
+            ans[i]=parent->Trace(index[i],buf).SNR(W);
+        });
+        return ans;
+    }
+
+    std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
+    XCorrStack(const std::vector<double> &center_time, const double &t1, const double &t2, const int loopN=5) const {
+        if (!SameSamplingRate())
+            throw std::runtime_error("Tried to XCorrStack signals with different sample rate.");
+        if (center_time.size()!=Size())
+            throw std::runtime_error("In XCorrStack, # of signals doesn't agree with # of windows.");
+        return parent->XCorrStack(index,center_time,t1,t2,loopN);
+    }
+    std::pair<std::pair<std::vector<double>,std::vector<double>>,std::pair<EvenSampledSignal,EvenSampledSignal>>
+    XCorrStack(const double &center_time, const double &t1, const double &t2, const int loopN=5) const {
+        return XCorrStack(std::vector<double> (Size(),center_time),t1,t2,loopN);
+    }
+};
+
+typedef BasicSACSignalsView<double> SACSignalsView;
+typedef BasicSACSignalsView<float> FloatSACSignalsView;
+
+#endif
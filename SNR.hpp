@@ -5,9 +5,10 @@
 #include<vector>
 #include<cmath>
 #include<numeric>
+#include<array>
 
 #include<Amplitude.hpp>
-#include<Envelope.hpp>
+#include<AnalyticSignal.hpp>
 #include<SimpsonRule.hpp>
 
 /***********************************************************
@@ -29,6 +30,11 @@
  * 2. Find the averaged absolute amplitude through the noise window. (after taking envelope)
  * 3. Take the ratio.
  *
+ * The Hilbert transform is calculated once for the whole trace (see
+ * AnalyticSignal.hpp); the envelope only within the windows. To measure
+ * several window pairs on one trace, use the second form, which shares the
+ * Hilbert transform between them.
+ *
  * input(s):
  * const vector<T> &p       ----  Input array pointer.
  * const int       &nloc    ----  Noise window start position.
@@ -40,64 +46,101 @@
  * return(s):
  * double ans  ----  SNR estimation.
  *
+ *
+ * alternatively, input(s):
+ * const vector<T> &p                       ----  Input array pointer.
+ * const vector<array<int,4>> &windows      ----  {nloc,nlen,sloc,slen} of each measurement.
+ * const int       &method                  ----  Choose one method above, default is 0.
+ *
+ * return(s):
+ * vector<double> ans  ----  SNR estimation of each window pair.
+ *
  * Shule Yu
  * Jan 20 2018
  *
  * Key words: signal to noise ratio, SNR
 ***********************************************************/
 
-template<typename T>
-double SNR(const std::vector<T> &p,const int &nloc,const int &nlen,const int &sloc,const int &slen,const int &method=0){
+namespace SNRHidden {
 
-    int npts=p.size();
-
-    if (nloc<0 || nloc>npts || nlen<0 || nloc+nlen>npts){
-        std::cerr <<  "Error in " << __func__ << ": Noise window error ..." << std::endl;
-        return 0.0;
-    }
-    if (sloc<0 || sloc>npts || slen<0 || sloc+slen>npts){
-        std::cerr <<  "Error in " << __func__ << ": Signal window error ..." << std::endl;
-        return 0.0;
+    // envelope of p within [loc,loc+len), from the Hilbert transform h.
+    template<typename T>
+    std::vector<double> Envelope(const std::vector<T> &p, const std::vector<double> &h, const int &loc, const int &len){
+        std::vector<double> ans(len);
+        for (int i=0;i<len;++i) ans[i]=sqrt(h[loc+i]*h[loc+i]+1.0*p[loc+i]*p[loc+i]);
+        return ans;
     }
 
-    double Slevel,Nlevel;
-    std::vector<double> res;
+    // h: Hilbert transform of p (not used by method 1).
+    template<typename T>
+    double SNR(const std::vector<T> &p, const std::vector<double> &h, const int &nloc, const int &nlen,
+               const int &sloc, const int &slen, const int &method){
 
-    switch (method){
+        int npts=p.size();
 
-        case 0:
+        if (nloc<0 || nloc>npts || nlen<0 || nloc+nlen>npts){
+            std::cerr <<  "Error in " << __func__ << ": Noise window error ..." << std::endl;
+            return 0.0;
+        }
+        if (sloc<0 || sloc>npts || slen<0 || sloc+slen>npts){
+            std::cerr <<  "Error in " << __func__ << ": Signal window error ..." << std::endl;
+            return 0.0;
+        }
 
-            res=Envelope(p);
+        double Slevel,Nlevel;
+        std::vector<double> res;
 
-            // integrate the envelope using Simpson's rule.
-            Slevel=SimpsonRule(res.begin()+sloc,res.begin()+sloc+slen,0.1);
-            Nlevel=SimpsonRule(res.begin()+nloc,res.begin()+nloc+nlen,0.1);
+        switch (method){
 
-            // average with respect to their length.
-            return Slevel/Nlevel*(1.0*nlen/slen);
+            case 0:
 
-        case 1:
+                // integrate the envelope using Simpson's rule.
+                res=Envelope(p,h,sloc,slen);
+                Slevel=SimpsonRule(res.begin(),res.end(),0.1);
+                res=Envelope(p,h,nloc,nlen);
+                Nlevel=SimpsonRule(res.begin(),res.end(),0.1);
 
-            Slevel=Amplitude(p.begin()+sloc,p.begin()+sloc+slen).first;
-            Nlevel=Amplitude(p.begin()+nloc,p.begin()+nloc+nlen).first;
+                // average with respect to their length.
+                return Slevel/Nlevel*(1.0*nlen/slen);
 
-            return Slevel/Nlevel;
+            case 1:
 
-        case 2:
+                Slevel=Amplitude(p.begin()+sloc,p.begin()+sloc+slen).first;
+                Nlevel=Amplitude(p.begin()+nloc,p.begin()+nloc+nlen).first;
 
-            res=Envelope(p);
+                return Slevel/Nlevel;
 
-            Slevel=Amplitude(p.begin()+sloc,p.begin()+sloc+slen).first;
-//             Nlevel=Amplitude(res.begin()+nloc,res.begin()+nloc+nlen).first;
-            Nlevel=std::accumulate(res.begin()+nloc,res.begin()+nloc+nlen,0.0)/nlen;
+            case 2:
 
-            return Slevel/Nlevel;
+                res=Envelope(p,h,nloc,nlen);
 
-        default:
+                Slevel=Amplitude(p.begin()+sloc,p.begin()+sloc+slen).first;
+//                 Nlevel=Amplitude(res.begin(),res.end()).first;
+                Nlevel=std::accumulate(res.begin(),res.end(),0.0)/nlen;
 
-            std::cerr <<  "Error in " << __func__ << ": Method error ..." << std::endl;
-            return -1;
+                return Slevel/Nlevel;
+
+            default:
+
+                std::cerr <<  "Error in " << __func__ << ": Method error ..." << std::endl;
+                return -1;
+        }
     }
 }
 
+template<typename T>
+double SNR(const std::vector<T> &p,const int &nloc,const int &nlen,const int &sloc,const int &slen,const int &method=0){
+    std::vector<double> h;
+    if (method==0 || method==2) h=AnalyticSignal(p,false).Hilbert;
+    return SNRHidden::SNR(p,h,nloc,nlen,sloc,slen,method);
+}
+
+template<typename T>
+std::vector<double> SNR(const std::vector<T> &p, const std::vector<std::array<int,4>> &windows, const int &method=0){
+    std::vector<double> h,ans;
+    if (!windows.empty() && (method==0 || method==2)) h=AnalyticSignal(p,false).Hilbert;
+    for (const auto &w: windows) ans.push_back(SNRHidden::SNR(p,h,w[0],w[1],w[2],w[3],method));
+    return ans;
+}
+
 #endif
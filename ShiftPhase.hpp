@@ -9,6 +9,8 @@ extern "C"{
 #include<fftw3.h>
 }
 
+#include<FFTWPlanCache.hpp>
+
 /*********************************************************************
  * This C++ template runs fft on input real signal, then shift each
  * frquency with a constant phase. Then ifft back to time domain and
@@ -36,12 +38,8 @@ std::vector<double> ShiftPhase(const std::vector<T> &x,const double &shift){
 
     int n=x.size(),N=n+(n%2);
 
-    double *In = new double [N];
-    fftw_complex *Out=(fftw_complex *)fftw_malloc((N/2+1)*sizeof(fftw_complex));;
-
-    // Define fft transform plan.
-    fftw_plan p1=fftw_plan_dft_r2c_1d(N,In,Out,FFTW_ESTIMATE);
-    fftw_plan p2=fftw_plan_dft_c2r_1d(N,Out,In,FFTW_ESTIMATE);
+    double *In=FFTWPlanCache::Real(N);
+    fftw_complex *Out=FFTWPlanCache::Complex(N/2+1);
 
     // Push data into the plan.
     // Pad the signal with one zero if the length of original signal is odd.
@@ -49,29 +47,23 @@ std::vector<double> ShiftPhase(const std::vector<T> &x,const double &shift){
     if (n%2==1) In[N-1]=0;
 
     // Run fft.
-    fftw_execute(p1);
+    fftw_execute_dft_r2c(FFTWPlanCache::R2C(N),In,Out);
 
-    // Shift phase.
-    double amp,phase;
+    // Shift phase: multiply by exp(i*shift).
+    double c=cos(shift*M_PI/180.0),s=sin(shift*M_PI/180.0);
     for (int i=0;i<N/2+1;++i){
-        amp=sqrt(Out[i][0]*Out[i][0]+Out[i][1]*Out[i][1]);
-        phase=atan2(Out[i][1],Out[i][0]);
-        Out[i][0]=amp*cos(phase+shift*M_PI/180.0);
-        Out[i][1]=amp*sin(phase+shift*M_PI/180.0);
+        double re=Out[i][0],im=Out[i][1];
+        Out[i][0]=re*c-im*s;
+        Out[i][1]=re*s+im*c;
     }
 
     // Run ifft.
-    fftw_execute(p2);
+    fftw_execute_dft_c2r(FFTWPlanCache::C2R(N),Out,In);
 
     // Get result. (ignore the last point if data length is odd)
     std::vector<double> ans;
     for (int i=0;i<n;++i) ans.push_back(1.0*In[i]/n);
 
-    fftw_destroy_plan(p1);
-    fftw_destroy_plan(p2);
-    fftw_free(Out);
-    delete [] In;
-
     return ans;
 }
 
@@ -0,0 +1,166 @@
+#ifndef ASU_SIGNALPIPELINE
+#define ASU_SIGNALPIPELINE
+
+#include<vector>
+#include<string>
+#include<functional>
+#include<stdexcept>
+
+#include<EvenSampledSignal.hpp>
+
+/*************************************************************
+ * This C++ template class holds an ordered chain of per-trace
+ * processing steps, to be run on each trace in one pass.
+ *
+ * Running the chain on a trace gives exactly the same result as calling
+ * the corresponding EvenSampledSignal / SACSignals member functions one
+ * after another (see the exception below), but the trace stays in cache
+ * between the steps. Use
+ * SACSignals::Apply(P) to run the chain on all records (in parallel, see
+ * SACSignals::SetThreads), e.g.:
+ *
+ *     SignalPipeline P;
+ *     P.RemoveTrend().HannTaper(10).Butterworth(0.03,0.3)
+ *      .CheckAndCutToWindow(-50,50).NormalizeToPeak();
+ *     s.Apply(P);
+ *
+ * is the same as:
+ *
+ *     s.RemoveTrend();
+ *     s.HannTaper(10);
+ *     s.Butterworth(0.03,0.3);
+ *     s.CheckAndCutToWindow(-50,50);
+ *     s.NormalizeToPeak();
+ *
+ * Steps taking a vector (e.g. CheckAndCutToWindow(center_time,t1,t2))
+ * use the element of the trace index, the vector size should match the
+ * record number when the chain is applied. Notice: the index is the record
+ * index before the chain is applied, records dropped by an earlier cut step
+ * don't shift it.
+ *
+ * Exception: the separate SACSignals calls take vectors sized and ordered
+ * like the records that survive the earlier cuts (RemoveRecords moves the
+ * last record into each removed slot). So a chain with a vector step
+ * (FindPeakAround(vec), CheckAndCutToWindow(vec,t1,t2)) after a cut step is
+ * only equivalent to the separate calls if those are given the vectors
+ * re-indexed that way; the chain itself always indexes by the original
+ * record. Chains whose vector steps all come before the first cut step
+ * (or that have no vector step) are bit-identical to the separate calls.
+ *
+ * member function(s):
+ * size_t Size() const                              ----  Number of steps.
+ * size_t Run(EvenSampledSignal &s, const size_t &i)  ----  Run the chain on trace i. Return the index of
+ *                                                      the cut step which drops the trace (the chain
+ *                                                      stops there), or Size() if the trace is kept.
+ * bool Check(const size_t &n) const                ----  Check the vector sizes against n records.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: pipeline, fused, preprocess, chain.
+*************************************************************/
+
+template<typename T>
+class BasicSignalPipeline {
+
+    // a step returns false if the trace should be dropped.
+    struct Step {
+        std::function<bool(BasicEvenSampledSignal<T> &, const std::size_t &)> f;
+        std::size_t n;                                 // required record number (0: any).
+    };
+    std::vector<Step> steps;
+
+    BasicSignalPipeline &Add(const std::function<bool(BasicEvenSampledSignal<T> &, const std::size_t &)> &f,
+                             const std::size_t &n=0){
+        steps.push_back({f,n});
+        return *this;
+    }
+
+public:
+
+    std::size_t Size() const {return steps.size();}
+
+    std::size_t Run(BasicEvenSampledSignal<T> &s, const std::size_t &i=0) const {
+        for (std::size_t k=0;k<steps.size();++k)
+            if (!steps[k].f(s,i)) return k;
+        return steps.size();
+    }
+
+    bool Check(const std::size_t &n) const {
+        for (const auto &item:steps)
+            if (item.n!=0 && item.n!=n) return false;
+        return true;
+    }
+
+    // Steps.
+    BasicSignalPipeline &Butterworth(const double &f1, const double &f2, const int &order=2, const int &passes=2){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){s.Butterworth(f1,f2,order,passes);return true;});
+    }
+
+    template<typename U>
+    BasicSignalPipeline &CheckAndCutToWindow(const std::vector<U> &center_time, const double &t1, const double &t2){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &i){
+            return s.CheckAndCutToWindow(center_time[i]+t1,center_time[i]+t2);
+        },center_time.size());
+    }
+    BasicSignalPipeline &CheckAndCutToWindow(const double &t1, const double &t2){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){
+            return s.CheckAndCutToWindow(0.0+t1,0.0+t2);
+        });
+    }
+
+    BasicSignalPipeline &Diff(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.Diff();return true;});
+    }
+
+    template<typename U>
+    BasicSignalPipeline &FindPeakAround(const std::vector<U> &center_time, const double &wl=5, const bool &positiveOnly=false){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &i){
+            s.FindPeakAround(center_time[i],wl,positiveOnly);return true;
+        },center_time.size());
+    }
+    BasicSignalPipeline &FindPeakAround(const double &center_time, const double &wl=5, const bool &positiveOnly=false){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){
+            s.FindPeakAround(center_time,wl,positiveOnly);return true;
+        });
+    }
+
+    BasicSignalPipeline &FlipPeakUp(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.FlipPeakUp();return true;});
+    }
+
+    BasicSignalPipeline &GaussianBlur(const double &sigma=1, const bool &Recursive=false){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){s.GaussianBlur(sigma,Recursive);return true;});
+    }
+
+    BasicSignalPipeline &HannTaper(const double &wl=10){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){s.HannTaper(wl);return true;});
+    }
+
+    BasicSignalPipeline &Integrate(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.Integrate();return true;});
+    }
+
+    BasicSignalPipeline &Interpolate(const double &dt){
+        return Add([=](BasicEvenSampledSignal<T> &s, const std::size_t &){
+            s=BasicEvenSampledSignal<T>(s,dt);return true;
+        });
+    }
+
+    BasicSignalPipeline &NormalizeToPeak(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.NormalizeToPeak();return true;});
+    }
+
+    BasicSignalPipeline &NormalizeToSignal(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.NormalizeToSignal();return true;});
+    }
+
+    BasicSignalPipeline &RemoveTrend(){
+        return Add([](BasicEvenSampledSignal<T> &s, const std::size_t &){s.RemoveTrend();return true;});
+    }
+};
+
+typedef BasicSignalPipeline<double> SignalPipeline;
+typedef BasicSignalPipeline<float> FloatSignalPipeline;
+
+#endif
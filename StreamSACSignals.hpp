@@ -0,0 +1,128 @@
+#ifndef ASU_STREAMSACSIGNALS
+#define ASU_STREAMSACSIGNALS
+
+#include<iostream>
+#include<fstream>
+#include<string>
+#include<vector>
+#include<functional>
+#include<future>
+#include<algorithm>
+
+#include<SACSignals.hpp>
+#include<SACArchive.hpp>
+
+/*************************************************************
+ * This C++ function processes a data set too large to fit in
+ * memory as a sequence of SACSignals batches.
+ *
+ * Records are read batchSize at a time, every operation in the chain
+ * is applied to the batch (in the given order), then the batch is
+ * handed to the sink and dropped. The next batch is read in the
+ * background while the current one is processed, so at most two
+ * batches are held in memory at any time.
+ *
+ * Each batch is an ordinary SACSignals object, so any member function
+ * can be used in the chain, e.g.:
+ *
+ *     SACArchive::Writer W("out.arch");
+ *     StreamSACSignals("list",500,
+ *                      {[](SACSignals &s){s.RemoveTrend();},
+ *                       [](SACSignals &s){s.HannTaper(10);},
+ *                       [](SACSignals &s){s.Butterworth(0.03,0.3);},
+ *                       [](SACSignals &s){s.CheckAndCutToWindow(-50,50);}},
+ *                      [&](const SACSignals &s, const std::size_t &first){s.WriteArchive(W);});
+ *
+ * Operations that combine records (stacking, normalize to global ...)
+ * only see the records within the current batch.
+ *
+ * input(s):
+ * const string / vector<string> / SACArchive::Reader &input
+ *                                      ----  A file contains path(s) to SAC file(s) /
+ *                                            path(s) to SAC file(s) / an archive.
+ * const size_t &batchSize              ----  Number of input records per batch.
+ * const vector<function> &ops          ----  Operations, called as op(batch).
+ * const function &sink                 ----  Called as sink(batch,first) after the operations.
+ *                                            first is the index of the first input record
+ *                                            of the batch.
+ * const size_t &nThreads               ----  (default 1) Number of threads used to read each batch.
+ *
+ * return(s):
+ * size_t ans  ----  Total number of records handed to the sink.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: out-of-core, stream, batch, chunk, sac.
+*************************************************************/
+
+namespace StreamSACSignalsHidden {
+
+    // read batch b with load(b), overlapping the read of batch b+1 with the processing of batch b.
+    std::size_t Run(const std::size_t &n, const std::size_t &batchSize,
+                    const std::function<SACSignals(const std::size_t &, const std::size_t &)> &load,
+                    const std::vector<std::function<void(SACSignals &)>> &ops,
+                    const std::function<void(const SACSignals &, const std::size_t &)> &sink){
+
+        if (batchSize==0)
+            throw std::runtime_error("StreamSACSignals batch size is zero ...");
+
+        std::size_t ans=0;
+        if (n==0) return ans;
+
+        auto next=std::async(std::launch::async,load,0,std::min(batchSize,n));
+        for (std::size_t first=0;first<n;first+=batchSize) {
+
+            SACSignals batch=next.get();
+
+            std::size_t nextFirst=first+batchSize;
+            if (nextFirst<n)
+                next=std::async(std::launch::async,load,nextFirst,std::min(batchSize,n-nextFirst));
+
+            for (const auto &op:ops) op(batch);
+            sink(batch,first);
+            ans+=batch.Size();
+        }
+        return ans;
+    }
+}
+
+std::size_t StreamSACSignals(const std::vector<std::string> &infiles, const std::size_t &batchSize,
+                             const std::vector<std::function<void(SACSignals &)>> &ops,
+                             const std::function<void(const SACSignals &, const std::size_t &)> &sink,
+                             const std::size_t &nThreads=1){
+
+    auto load=[&](const std::size_t &first, const std::size_t &len){
+        return SACSignals(std::vector<std::string>(infiles.begin()+first,infiles.begin()+first+len),nThreads);
+    };
+    return StreamSACSignalsHidden::Run(infiles.size(),batchSize,load,ops,sink);
+}
+
+std::size_t StreamSACSignals(const std::string &infile, const std::size_t &batchSize,
+                             const std::vector<std::function<void(SACSignals &)>> &ops,
+                             const std::function<void(const SACSignals &, const std::size_t &)> &sink,
+                             const std::size_t &nThreads=1){
+
+    std::ifstream fpin(infile);
+    std::vector<std::string> infiles;
+    std::string sacfilename;
+    while (fpin >> sacfilename) infiles.push_back(sacfilename);
+    fpin.close();
+
+    return StreamSACSignals(infiles,batchSize,ops,sink,nThreads);
+}
+
+std::size_t StreamSACSignals(const SACArchive::Reader &archive, const std::size_t &batchSize,
+                             const std::vector<std::function<void(SACSignals &)>> &ops,
+                             const std::function<void(const SACSignals &, const std::size_t &)> &sink,
+                             const std::size_t &nThreads=1){
+
+    auto load=[&](const std::size_t &first, const std::size_t &len){
+        std::vector<std::size_t> indices(len);
+        for (std::size_t i=0;i<len;++i) indices[i]=first+i;
+        return SACSignals(archive,indices,nThreads);
+    };
+    return StreamSACSignalsHidden::Run(archive.Size(),batchSize,load,ops,sink);
+}
+
+#endif
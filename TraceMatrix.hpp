@@ -0,0 +1,139 @@
+#ifndef ASU_TRACEMATRIX
+#define ASU_TRACEMATRIX
+
+#include<vector>
+#include<memory>
+#include<cstdlib>
+#include<cstring>
+#include<cmath>
+#include<algorithm>
+#include<stdexcept>
+#include<sys/mman.h>
+
+/*************************************************************
+ * This C++ template class holds equal-length traces as the rows
+ * of one contiguous, aligned, row-major matrix.
+ *
+ * Each row starts on a 64-byte boundary (row stride is padded, the
+ * padding is zero), so rows can be streamed with aligned SIMD loads.
+ * Buffers of 2 MB or more are aligned to 2 MB and advised to use
+ * transparent huge pages when the system supports it.
+ *
+ * Use it for batch kernels running over many traces at once. The
+ * batch kernels provided here accumulate in double:
+ *
+ *     SumRows(w)    ----  sum_i w[i]*row_i (w empty: all weights are 1).
+ *     MaxAbs()      ----  max|row_i| for each row.
+ *     ScaleRows(s)  ----  row_i *= s[i].
+ *
+ * SACSignals::Pack/Unpack convert records to/from a TraceMatrix;
+ * MakeNeatStack and NormalizeToGlobal use SumRows and MaxAbs.
+ *
+ * constructor input(s):
+ * const size_t &rows  ----  Number of traces.
+ * const size_t &cols  ----  Number of samples per trace.
+ *
+ * member function(s):
+ * size_t Rows() / Cols() / Stride() const  ----  Stride: distance between rows (in elements).
+ * T *Row(const size_t &i)                  ----  Pointer to the first sample of row i.
+ * T *Data()                                ----  Pointer to the whole buffer (Rows()*Stride()).
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: matrix, contiguous, aligned, batch, SIMD.
+*************************************************************/
+
+template<typename T>
+class TraceMatrix {
+
+    struct Free {void operator()(T *p) const {free(p);}};
+
+    std::size_t rows,cols,stride;
+    std::unique_ptr<T[],Free> buf;
+
+    void Allocate() {
+        std::size_t align=64,bytes=rows*stride*sizeof(T);
+        if (bytes==0) {buf.reset();return;}
+        if (bytes>=(1<<21)) align=(1<<21);
+        void *p=nullptr;
+        if (posix_memalign(&p,align,bytes)!=0)
+            throw std::runtime_error("TraceMatrix allocation failed ...");
+#ifdef MADV_HUGEPAGE
+        if (align==(1<<21)) madvise(p,bytes,MADV_HUGEPAGE);
+#endif
+        memset(p,0,bytes);
+        buf.reset(static_cast<T *>(p));
+    }
+
+public:
+
+    TraceMatrix () : rows(0), cols(0), stride(0) {}
+
+    TraceMatrix (const std::size_t &r, const std::size_t &c) : rows(r), cols(c) {
+        std::size_t k=64/sizeof(T);
+        stride=(cols+k-1)/k*k;
+        Allocate();
+    }
+
+    TraceMatrix (const TraceMatrix &item) : rows(item.rows), cols(item.cols), stride(item.stride) {
+        Allocate();
+        if (buf) memcpy(buf.get(),item.buf.get(),rows*stride*sizeof(T));
+    }
+
+    TraceMatrix (TraceMatrix &&item) = default;
+
+    TraceMatrix &operator=(const TraceMatrix &item) {
+        if (this!=&item) *this=TraceMatrix(item);
+        return *this;
+    }
+
+    TraceMatrix &operator=(TraceMatrix &&item) = default;
+
+    std::size_t Rows() const {return rows;}
+    std::size_t Cols() const {return cols;}
+    std::size_t Stride() const {return stride;}
+
+    T *Data() {return buf.get();}
+    const T *Data() const {return buf.get();}
+    T *Row(const std::size_t &i) {return buf.get()+i*stride;}
+    const T *Row(const std::size_t &i) const {return buf.get()+i*stride;}
+
+    std::vector<double> SumRows(const std::vector<double> &w=std::vector<double> ()) const {
+        if (!w.empty() && w.size()!=rows)
+            throw std::runtime_error("TraceMatrix::SumRows weight number doesn't match row number.");
+        std::vector<double> ans(cols,0);
+        for (std::size_t i=0;i<rows;++i) {
+            const T *x=Row(i);
+            if (w.empty())
+                for (std::size_t j=0;j<cols;++j) ans[j]+=x[j];
+            else {
+                double a=w[i];
+                for (std::size_t j=0;j<cols;++j) ans[j]+=a*x[j];
+            }
+        }
+        return ans;
+    }
+
+    std::vector<double> MaxAbs() const {
+        std::vector<double> ans(rows,0);
+        for (std::size_t i=0;i<rows;++i) {
+            const T *x=Row(i);
+            double m=0;
+            for (std::size_t j=0;j<cols;++j) m=std::max(m,(double)std::fabs(x[j]));
+            ans[i]=m;
+        }
+        return ans;
+    }
+
+    void ScaleRows(const std::vector<double> &s) {
+        if (s.size()!=rows)
+            throw std::runtime_error("TraceMatrix::ScaleRows scale number doesn't match row number.");
+        for (std::size_t i=0;i<rows;++i) {
+            T *x=Row(i);
+            for (std::size_t j=0;j<cols;++j) x[j]*=s[i];
+        }
+    }
+};
+
+#endif
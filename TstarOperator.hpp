@@ -11,6 +11,8 @@ extern "C"{
 #include<fftw3.h>
 }
 
+#include<FFTWPlanCache.hpp>
+
 #include<Normalize.hpp>
 
 /*********************************************************
@@ -69,9 +71,8 @@ TstarOperator(const double &ts, const double &delta, const double &tol=1e-3){
         // Notice length(IN) is N, while length(Out) is N/2+1, this is a convention
         // used in package fftw3: because the spectrum of a real signal has the
         // mirror property:  H(−f)=[H(f)]*, and fftw3 choose to only store the f>0 part.
-        double *In = new double [N];
-        fftw_complex *Out=(fftw_complex *)fftw_malloc((N/2+1)*sizeof(fftw_complex));;
-        fftw_plan p=fftw_plan_dft_c2r_1d(N,Out,In,FFTW_ESTIMATE);
+        double *In=FFTWPlanCache::Real(N);
+        fftw_complex *Out=FFTWPlanCache::Complex(N/2+1);
 
 
         // Create the spectrum of the t-star signal (only for the f>0 part).
@@ -88,18 +89,12 @@ TstarOperator(const double &ts, const double &delta, const double &tol=1e-3){
         }
 
         // Run ifft.
-        fftw_execute(p);
+        fftw_execute_dft_c2r(FFTWPlanCache::C2R(N),Out,In);
 
         // Get answer from the ifft plan.
         for (int i=0;i<n;++i) ans[i]=In[i];
 
 
-        // Destroy the ifft plan.
-        fftw_free(Out);
-        fftw_destroy_plan(p);
-        delete [] In;
-
-
         // Should we stop?
         auto MaxElement=max_element(ans.begin(),ans.end());
         auto MinElement=min_element(ans.begin(),ans.end());
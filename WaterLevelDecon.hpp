@@ -11,6 +11,8 @@ extern "C"{
 #include<fftw3.h>
 }
 
+#include<FFTWPlanCache.hpp>
+
 /*********************************************************************
  * This C++ template function returns a 1D array that contains the
  * "peak-kept" position of water-level deconvolution results:
@@ -60,12 +62,12 @@ std::vector<double> WaterLevelDecon(const std::vector<T1> &x, const std::size_t
     int NPTS=2*std::max(n,N);
 
     // Malloc space for FFT.
-    double *In = new double [NPTS];
-    fftw_complex *Out=(fftw_complex *)fftw_malloc((NPTS/2+1)*sizeof(fftw_complex));;
+    double *In=FFTWPlanCache::Real(NPTS);
+    fftw_complex *Out=FFTWPlanCache::Complex(NPTS/2+1);
 
-    // Define fft and ifft transform plan.
-    fftw_plan p1=fftw_plan_dft_r2c_1d(NPTS,In,Out,FFTW_MEASURE);
-    fftw_plan p2=fftw_plan_dft_c2r_1d(NPTS,Out,In,FFTW_MEASURE);
+    // fft and ifft transform plan (cached).
+    fftw_plan p1=FFTWPlanCache::R2C(NPTS,FFTW_MEASURE);
+    fftw_plan p2=FFTWPlanCache::C2R(NPTS,FFTW_MEASURE);
 
     // Step1. Calculate source fft.
 
@@ -74,7 +76,7 @@ std::vector<double> WaterLevelDecon(const std::vector<T1> &x, const std::size_t
     for (int i=0;i<N;++i) In[NPTS/2-py+i]=y[i];
 
     // 2. Run esf fft.
-    fftw_execute(p1);
+    fftw_execute_dft_r2c(p1,In,Out);
 
     // Step2. Water-level filled.
 
@@ -107,7 +109,7 @@ std::vector<double> WaterLevelDecon(const std::vector<T1> &x, const std::size_t
     for (int i=0;i<n;++i) In[NPTS/2-px+i]=x[i];
 
     // 2. FFT signal.
-    fftw_execute(p1);
+    fftw_execute_dft_r2c(p1,In,Out);
 
     // 3. Division.
     for (int i=0;i<NPTS/2+1;++i){
@@ -118,18 +120,12 @@ std::vector<double> WaterLevelDecon(const std::vector<T1> &x, const std::size_t
     }
 
     // 4. iFFT deconed traces.
-    fftw_execute(p2);
+    fftw_execute_dft_c2r(p2,Out,In);
 
     // 5. Rotate the deconed trace so that the peak stays around the center.
     std::vector<double> ans(NPTS,0);
     for (int i=0;i<NPTS;++i) ans[i]=In[(i+NPTS/2)%NPTS];
 
-    // Free spaces.
-    fftw_destroy_plan(p1);
-    fftw_destroy_plan(p2);
-    fftw_free(Out);
-    delete [] In;
-
     return ans;
 }
 
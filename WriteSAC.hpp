@@ -0,0 +1,75 @@
+#ifndef ASU_WRITESAC
+#define ASU_WRITESAC
+
+#include<string>
+#include<vector>
+#include<cstring>
+#include<algorithm>
+#include<fcntl.h>
+#include<unistd.h>
+
+#include<SACHeader.hpp>
+
+/*************************************************************
+ * This C++ template writes a binary SAC file without using the
+ * SAC library (newhdr/setfhv/wsac0).
+ *
+ * npts, e, depmin, depmax and depmen are set from the samples, all
+ * other header values are taken from hdr as is. The file is written in
+ * native byte order with a single write call (header and samples are
+ * packed into one buffer first). There is no global state, so it is
+ * safe to call from multiple threads.
+ *
+ * input(s):
+ * const string    &outfile  ----  SAC file name.
+ * const SACHeader &hdr      ----  Header (delta, b, station ... ).
+ * const vector<T> &amp      ----  Samples.
+ *
+ * return(s):
+ * bool ans  ----  true : success.
+ *                 false: can't create or write the file.
+ *
+ * Shule Yu
+ * Oct 16 2026
+ *
+ * Key words: sac, write, binary.
+*************************************************************/
+
+template<typename T>
+bool WriteSAC(const std::string &outfile, const SACHeader &hdr, const std::vector<T> &amp){
+
+    SACHeader h=hdr;
+    int npts=amp.size();
+    h.SetInt("npts",npts);
+    if (npts>0) {
+        double sum=0;
+        float xmin=amp[0],xmax=amp[0];
+        for (const auto &item:amp) {
+            xmin=std::min(xmin,(float)item);
+            xmax=std::max(xmax,(float)item);
+            sum+=item;
+        }
+        h.SetFloat("depmin",xmin);
+        h.SetFloat("depmax",xmax);
+        h.SetFloat("depmen",sum/npts);
+        h.SetFloat("e",h.GetFloat("b")+(npts-1)*h.GetFloat("delta"));
+    }
+
+    std::vector<char> buf(sizeof(SACHeader)+sizeof(float)*npts);
+    memcpy(buf.data(),&h,sizeof(SACHeader));
+    float *p=reinterpret_cast<float *>(buf.data()+sizeof(SACHeader));
+    for (int i=0;i<npts;++i) p[i]=amp[i];
+
+    int fd=open(outfile.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if (fd<0) return false;
+
+    std::size_t done=0;
+    while (done<buf.size()) {
+        ssize_t n=write(fd,buf.data()+done,buf.size()-done);
+        if (n<=0) break;
+        done+=n;
+    }
+    return (close(fd)==0 && done==buf.size());
+}
+
+#endif